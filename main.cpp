@@ -6,6 +6,9 @@
 
 #include <iostream>		// cout() ...
 #include <vector>		// vector <AType> ...
+#include <map>			// map <AKey, AType> ...
+#include <functional>	// function <AType> ...
+#include <memory>		// shared_ptr <AType> ...
 #include <random>		// random_device ...
 #include <iomanip>		// setwp() ...
 #include <ncurses.h>	// initscr() ...
@@ -13,22 +16,698 @@
 #include <unistd.h>		// ioctl() ...
 #include <fstream>		// ifstream() ...
 #include <utility>		// make_pair() ...
+#include <algorithm>	// fill() ...
+#include <cerrno>		// errno ...
+#include <cstdint>		// uint64_t ...
+#include <cstring>		// memchr() ...
+#include <fcntl.h>		// open() ...
+#include <sys/stat.h>	// fstat() ...
+#include <poll.h>		// poll() ...
+#include <thread>		// thread ...
+#include <atomic>		// atomic <AType> ...
+#include <chrono>		// steady_clock ...
+#include <cstdlib>		// malloc() ...
+#include <limits>		// numeric_limits <AType> ...
+#include <climits>		// IOV_MAX ...
+#include <cstdio>		// rename() ...
+#include <sys/uio.h>	// writev() ...
+#include <dirent.h>		// opendir() ...
+#include <unordered_map>	// unordered_map <AKey, AType> ...
+#if defined(__SSE2__)
+#include <immintrin.h>	// _mm_cmpeq_epi8() ...
+#endif
 
 
 using namespace std;
 
 /*
 
-Compilation préconisée :  rm main.out; g++ -std=c++11  CMIFUC.cpp -o main.out -Wall -ltinfo -lncurses;  ./main.out
+Compilation préconisée :  rm main.out; g++ -std=c++11  CMIFUC.cpp -o main.out -Wall -ltinfo -lncurses -pthread;  ./main.out
+Allocations comptées par --bench : ajouter -DBENCH_COUNT_ALLOC (binaire de mesure uniquement, operator new est alors remplacé)
 Package à installer : libncurses5-dev (sudo apt-get install libncurses5-dev)
 
 */
 
 
-/*!
-* \brief Alias to the matrix
+/**
+* \class CMatrice
+* \brief Matrice de jeu stockée en un seul bloc contigu.
+*
+* Les cases sont rangées ligne par ligne (row-major) dans un unique buffer alloué une seule fois.
+* Matrice[Ligne][Colonne] conserve la même sémantique que l'ancien vector <vector <char>>.
+*/
+class CMatrice {
+public:
+	static const bool KIsSparse = false;	/*!< every case is allocated */
+
+	CMatrice() : m_NbLine(0), m_NbColumn(0) {}
+
+	CMatrice(const unsigned NbLine, const unsigned NbColumn, const char Token)
+		: m_NbLine(NbLine), m_NbColumn(NbColumn), m_Cells(size_t(NbLine) * NbColumn, Token) {}
+
+	/*!
+	* \brief Resize the matrix and fill every case with Token (single allocation)
+	* \param[in] NbLine The matrix size (axe Y)
+	* \param[in] NbColumn The matrix size (axe X)
+	* \param[in] Token Token written in every case
+	*/
+	void Resize(const unsigned NbLine, const unsigned NbColumn, const char Token) {
+		m_NbLine = NbLine;
+		m_NbColumn = NbColumn;
+		m_Cells.assign(size_t(NbLine) * NbColumn, Token);
+	}
+
+	/*!
+	* \brief Fill every case with Token
+	* \param[in] Token Token to write
+	*/
+	void Fill(const char Token) { fill(m_Cells.begin(), m_Cells.end(), Token); }
+
+	/*!
+	* \brief Fill a rectangle with Token, clipped to the matrix
+	* \param[in] Line First line of the rectangle
+	* \param[in] Column First column of the rectangle
+	* \param[in] Height Rectangle height
+	* \param[in] Width Rectangle width
+	* \param[in] Token Token to write
+	*/
+	void FillRect(const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width, const char Token) {
+		const unsigned LastLine = min(Line + Height, m_NbLine);
+		const unsigned LastColumn = min(Column + Width, m_NbColumn);
+		if (Column >= LastColumn) return;
+
+		for (unsigned i(Line); i < LastLine; ++i)
+			fill((*this)[i] + Column, (*this)[i] + LastColumn, Token);
+	}
+
+	char * operator [] (const unsigned Line) { return m_Cells.data() + size_t(Line) * m_NbColumn; }
+	const char * operator [] (const unsigned Line) const { return m_Cells.data() + size_t(Line) * m_NbColumn; }
+
+	char Get(const unsigned Line, const unsigned Column) const { return (*this)[Line][Column]; }
+	void Set(const unsigned Line, const unsigned Column, const char Token) { (*this)[Line][Column] = Token; }
+	void SetRow(const unsigned Line, const unsigned Column, const char * Cases, const unsigned Width) { copy(Cases, Cases + Width, (*this)[Line] + Column); }
+
+	unsigned NbLine() const { return m_NbLine; }
+	unsigned NbColumn() const { return m_NbColumn; }
+	size_t NbCase() const { return m_Cells.size(); }
+	bool Empty() const { return m_Cells.empty(); }
+
+	char * Data() { return m_Cells.data(); }
+	const char * Data() const { return m_Cells.data(); }
+
+private:
+	unsigned m_NbLine;
+	unsigned m_NbColumn;
+	vector <char> m_Cells;
+}; //CMatrice
+
+/**
+* \class CChunkedMatrice
+* \brief Matrice de jeu creuse, découpée en tuiles de 64x64 cases allouées à la première écriture.
+*
+* Une tuile jamais écrite n'existe pas : sa lecture renvoie la tuile vide partagée (toutes les cases au jeton de fond).
+* La mémoire suit le contenu posé et non la surface de la carte : seules les tuiles touchées par un joueur, un obstacle
+* ou un bonus sont allouées. Get(), Set(), FillRect(), NbLine() et NbColumn() ont la même sémantique que dans CMatrice,
+* MovePlayer(), GetBonus(), PutObstacle() et PutBonus() acceptent donc l'une ou l'autre.
+*/
+class CChunkedMatrice {
+public:
+	static const bool KIsSparse = true;	/*!< only the tiles written are allocated */
+	static const unsigned KTileShift = 6;
+	static const unsigned KTileSize = 1 << KTileShift;	/*!< côté d'une tuile (cases) */
+
+	CChunkedMatrice() : m_NbLine(0), m_NbColumn(0), m_Empty(0), m_LastKey(KNoTile), m_LastTile(nullptr) {}
+
+	CChunkedMatrice(const unsigned NbLine, const unsigned NbColumn, const char Token) : CChunkedMatrice() {
+		Resize(NbLine, NbColumn, Token);
+	}
+
+	/*!
+	* \brief Free every tile and size the matrix : every case reads Token
+	* \param[in] NbLine The matrix size (axe Y)
+	* \param[in] NbColumn The matrix size (axe X)
+	* \param[in] Token Background token
+	*/
+	void Resize(const unsigned NbLine, const unsigned NbColumn, const char Token) {
+		m_NbLine = NbLine;
+		m_NbColumn = NbColumn;
+		m_Empty = Token;
+		m_EmptyTile.assign(KTileSize * KTileSize, Token);
+		m_Tiles.clear();
+		m_LastKey = KNoTile;
+		m_LastTile = nullptr;
+	}
+
+	/*!
+	* \brief Read a case
+	* \param[in] Line Line of the case
+	* \param[in] Column Column of the case
+	* \return The token of the case
+	*/
+	char Get(const unsigned Line, const unsigned Column) const {
+		const char * Tile = FindTile(Line, Column);
+		return (nullptr == Tile ? m_EmptyTile.data() : Tile)[Offset(Line, Column)];
+	}
+
+	/*!
+	* \brief Write a case : its tile is allocated unless Token is the background token
+	* \param[in] Line Line of the case
+	* \param[in] Column Column of the case
+	* \param[in] Token Token to write
+	*/
+	void Set(const unsigned Line, const unsigned Column, const char Token) {
+		char * Tile = FindTile(Line, Column);
+		if (nullptr == Tile) {
+			if (m_Empty == Token) return;
+			Tile = NewTile(Line, Column);
+		}
+		Tile[Offset(Line, Column)] = Token;
+	}
+
+	/*!
+	* \brief Fill a rectangle with Token, clipped to the matrix, tile by tile
+	* \param[in] Line First line of the rectangle
+	* \param[in] Column First column of the rectangle
+	* \param[in] Height Rectangle height
+	* \param[in] Width Rectangle width
+	* \param[in] Token Token to write
+	*/
+	void FillRect(const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width, const char Token) {
+		const unsigned LastLine = min(Line + Height, m_NbLine);
+		const unsigned LastColumn = min(Column + Width, m_NbColumn);
+
+		for (unsigned TileLine(Line); TileLine < LastLine; TileLine = (TileLine | (KTileSize - 1)) + 1) {
+			const unsigned EndLine = min(LastLine, (TileLine | (KTileSize - 1)) + 1);
+
+			for (unsigned TileColumn(Column); TileColumn < LastColumn; TileColumn = (TileColumn | (KTileSize - 1)) + 1) {
+				const unsigned EndColumn = min(LastColumn, (TileColumn | (KTileSize - 1)) + 1);
+
+				char * Tile = FindTile(TileLine, TileColumn);
+				if (nullptr == Tile) {
+					if (m_Empty == Token) continue;
+					Tile = NewTile(TileLine, TileColumn);
+				}
+				for (unsigned i(TileLine); i < EndLine; ++i)
+					fill(Tile + Offset(i, TileColumn), Tile + Offset(i, EndColumn - 1) + 1, Token);
+			}
+		}
+	}
+
+	/*!
+	* \brief Write a part of a line : the tiles where every case is the background token are not allocated
+	* \param[in] Line The line
+	* \param[in] Column First column written
+	* \param[in] Cases The tokens
+	* \param[in] Width Number of cases
+	*/
+	void SetRow(const unsigned Line, const unsigned Column, const char * Cases, const unsigned Width) {
+		for (unsigned First(Column); First < Column + Width; First = (First | (KTileSize - 1)) + 1) {
+			const unsigned Last = min(Column + Width, (First | (KTileSize - 1)) + 1);
+			const char * Part = Cases + (First - Column);
+
+			char * Tile = FindTile(Line, First);
+			if (nullptr == Tile) {
+				if (Part + (Last - First) == find_if(Part, Part + (Last - First), [this](const char Case) { return m_Empty != Case; })) continue;
+				Tile = NewTile(Line, First);
+			}
+			copy(Part, Part + (Last - First), Tile + Offset(Line, First));
+		}
+	}
+
+	/*!
+	* \brief Copy a part of a line into a buffer
+	* \param[in] Line The line
+	* \param[in] Column First column read
+	* \param[in] Width Number of cases
+	* \param[out] Cases The tokens (Width cases)
+	*/
+	void CopyRow(const unsigned Line, const unsigned Column, const unsigned Width, char * Cases) const {
+		for (unsigned First(Column); First < Column + Width; First = (First | (KTileSize - 1)) + 1) {
+			const unsigned Last = min(Column + Width, (First | (KTileSize - 1)) + 1);
+			const char * Tile = FindTile(Line, First);
+			const char * Part = (nullptr == Tile ? m_EmptyTile.data() : Tile) + Offset(Line, First);
+			copy(Part, Part + (Last - First), Cases + (First - Column));
+		}
+	}
+
+	/*!
+	* \brief Read a part of a line in place
+	* \param[in] Line The line
+	* \param[in] Column First column read
+	* \return The cases from Column to the end of its tile, nullptr if the tile is not allocated (every case is the background token)
+	*/
+	const char * FindRow(const unsigned Line, const unsigned Column) const {
+		const char * Tile = FindTile(Line, Column);
+		return (nullptr == Tile ? nullptr : Tile + Offset(Line, Column));
+	}
+
+	/*!
+	* \brief Call Op(Line, Column, Cases) on every allocated tile (no order)
+	* \param[in] Op The function to call : first line and first column of the tile, its KTileSize lines of KTileSize cases
+	*/
+	template <typename TOp>
+	void ForEachTile(TOp Op) const {
+		for (const auto & Tile : m_Tiles)
+			Op(unsigned(Tile.first >> 32) << KTileShift, unsigned(Tile.first) << KTileShift, static_cast <const char *> (Tile.second.get()));
+	}
+
+	unsigned NbLine() const { return m_NbLine; }
+	unsigned NbColumn() const { return m_NbColumn; }
+	bool Empty() const { return 0 == m_NbLine || 0 == m_NbColumn; }
+	char Background() const { return m_Empty; }	/*!< jeton des cases des tuiles non allouées */
+	size_t NbTile() const { return m_Tiles.size(); }
+	size_t MemorySize() const { return (m_Tiles.size() + 1) * KTileSize * KTileSize; }	/*!< octets des cases allouées */
+
+private:
+	static const uint64_t KNoTile = ~uint64_t(0);
+
+	static uint64_t Key(const unsigned Line, const unsigned Column) {
+		return (uint64_t(Line >> KTileShift) << 32) | (Column >> KTileShift);
+	}
+	static unsigned Offset(const unsigned Line, const unsigned Column) {
+		return ((Line & (KTileSize - 1)) << KTileShift) | (Column & (KTileSize - 1));
+	}
+
+	/* La dernière tuile trouvée est gardée : un déplacement reste presque toujours dans la même tuile */
+	char * FindTile(const unsigned Line, const unsigned Column) const {
+		const uint64_t TileKey = Key(Line, Column);
+		if (TileKey == m_LastKey) return m_LastTile;
+
+		const auto Found = m_Tiles.find(TileKey);
+		m_LastKey = TileKey;
+		m_LastTile = (m_Tiles.end() == Found ? nullptr : Found->second.get());
+		return m_LastTile;
+	}
+
+	char * NewTile(const unsigned Line, const unsigned Column) {
+		unique_ptr <char[]> & Tile = m_Tiles[Key(Line, Column)];
+		Tile.reset(new char[KTileSize * KTileSize]);
+		fill(Tile.get(), Tile.get() + KTileSize * KTileSize, m_Empty);
+
+		m_LastKey = Key(Line, Column);
+		m_LastTile = Tile.get();
+		return m_LastTile;
+	}
+
+	unsigned m_NbLine;
+	unsigned m_NbColumn;
+	char m_Empty;
+	vector <char> m_EmptyTile;
+	unordered_map <uint64_t, unique_ptr <char[]>> m_Tiles;
+	mutable uint64_t m_LastKey;
+	mutable char * m_LastTile;
+}; //CChunkedMatrice
+
+/**
+* \class CRandom
+* \brief Générateur pseudo-aléatoire xoshiro256** initialisé par une graine.
+*
+* Un seul moteur est créé pour tout le processus : une même graine redonne exactement le même plateau.
+*/
+class CRandom {
+public:
+	explicit CRandom(const uint64_t Seed = 0) { SetSeed(Seed); }
+
+	/*!
+	* \brief Reset the engine state from a seed (splitmix64)
+	* \param[in] Seed The seed
+	*/
+	void SetSeed(uint64_t Seed) {
+		m_Seed = Seed;
+		for (unsigned i(0); i < 4; ++i) {
+			uint64_t Z = (Seed += 0x9E3779B97F4A7C15ULL);
+			Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+			m_State[i] = Z ^ (Z >> 31);
+		}
+	}
+
+	uint64_t GetSeed() const { return m_Seed; }
+
+	/*!
+	* \brief Copy the engine state (to restart the same sequence later)
+	* \param[out] State The 4 words of the state
+	*/
+	void GetState(uint64_t State[4]) const {
+		for (unsigned i(0); i < 4; ++i) State[i] = m_State[i];
+	}
+
+	/*!
+	* \brief Restore an engine state copied by GetState() (the seed is unchanged)
+	* \param[in] State The 4 words of the state
+	*/
+	void SetState(const uint64_t State[4]) {
+		for (unsigned i(0); i < 4; ++i) m_State[i] = State[i];
+	}
+
+	/*!
+	* \brief Get the next 64 random bits
+	* \return Random value
+	*/
+	uint64_t Next() {
+		const uint64_t Result = Rotl(m_State[1] * 5, 7) * 9;
+		const uint64_t T = m_State[1] << 17;
+
+		m_State[2] ^= m_State[0];
+		m_State[3] ^= m_State[1];
+		m_State[1] ^= m_State[2];
+		m_State[0] ^= m_State[3];
+		m_State[2] ^= T;
+		m_State[3] = Rotl(m_State[3], 45);
+
+		return Result;
+	}
+
+	/*!
+	* \brief Get an unbiased random number (Lemire's method)
+	* \param[in] Min Minimum range
+	* \param[in] Max Maximum range
+	* \return Random number between Min and Max
+	*/
+	int Range(const int Min, const int Max) {
+		if (Max <= Min) return Min;
+
+		const uint32_t Size = uint32_t(int64_t(Max) - Min + 1);
+		if (0 == Size) return int(uint32_t(Next() >> 32));	/* tout l'intervalle des int */
+
+		uint64_t M = (Next() >> 32) * Size;
+
+		if (uint32_t(M) < Size) {
+			const uint32_t Threshold = uint32_t(-Size) % Size;
+			while (uint32_t(M) < Threshold) M = (Next() >> 32) * Size;
+		}
+
+		return int(int64_t(Min) + int64_t(M >> 32));
+	}
+
+private:
+	static uint64_t Rotl(const uint64_t X, const int K) { return (X << K) | (X >> (64 - K)); }
+
+	uint64_t m_State[4];
+	uint64_t m_Seed;
+}; //CRandom
+
+/**
+* \class CBitBoard
+* \brief Calque d'une carte : un bit par case, 64 cases par mot, rangés en tuiles de 64x64 cases allouées à la première écriture.
+*
+* Une tuile est une colonne de 64 mots (un mot par ligne) : un rectangle se lit ou s'écrit mot par mot (masques de début et
+* de fin de ligne), ce qui permet de tester une collision ou un chevauchement sur 64 cases à la fois.
+* Une tuile sans aucun bit posé n'existe pas (sa lecture renvoie KEmptyTile) : la mémoire suit le contenu posé depuis le
+* dernier Reset() et non la surface, et Insert() hors du calque ne fait qu'élargir ses bornes. Les tuiles sont rangées dans
+* une table de hachage, avec un petit cache des dernières tuiles lues : un déplacement ou un parcours ligne par ligne ne
+* cherche une tuile qu'une fois toutes les 64 lignes.
 */
-typedef vector <vector <char>> CMatrice;
+class CBitBoard {
+public:
+	static const unsigned KTileShift = 6;
+	static const unsigned KTileSize = 1 << KTileShift;	/*!< côté d'une tuile (cases) */
+
+	CBitBoard() : m_Width(0), m_Height(0), m_Stride(0) { ForgetTiles(); }
+
+	CBitBoard(const CBitBoard & Other) : m_Width(Other.m_Width), m_Height(Other.m_Height), m_Stride(Other.m_Stride), m_Tiles(Other.m_Tiles) {
+		ForgetTiles();
+	}
+
+	CBitBoard & operator = (const CBitBoard & Other) {
+		m_Width = Other.m_Width;
+		m_Height = Other.m_Height;
+		m_Stride = Other.m_Stride;
+		m_Tiles = Other.m_Tiles;
+		ForgetTiles();
+		return *this;
+	}
+
+	/*!
+	* \brief Empty the layer (every tile is freed) and size it to a matrix
+	* \param[in] Width Number of columns (axe X)
+	* \param[in] Height Number of lines (axe Y)
+	*/
+	void Reset(const unsigned Width, const unsigned Height) {
+		m_Width = Width;
+		m_Height = Height;
+		m_Stride = (Width + 63) / 64;
+		m_Tiles.clear();
+		ForgetTiles();
+	}
+
+	/*!
+	* \brief Check if a case is set
+	* \param[in] X Position X
+	* \param[in] Y Position Y
+	* \return True if (X, Y) is set
+	*/
+	bool Contains(const unsigned X, const unsigned Y) const {
+		if (X >= m_Width || Y >= m_Height) return false;
+		return (ReadTile(Y, X / 64)[Y % KTileSize] >> (X % 64)) & 1;
+	}
+
+	/*!
+	* \brief Set a case (the bounds of the layer grow if needed, without copy)
+	* \param[in] X Position X
+	* \param[in] Y Position Y
+	* \return False if (X, Y) was already set
+	*/
+	bool Insert(const unsigned X, const unsigned Y) {
+		if (X >= m_Width || Y >= m_Height) {
+			m_Width = max(X + 1, m_Width);
+			m_Height = max(Y + 1, m_Height);
+			m_Stride = (m_Width + 63) / 64;
+		}
+
+		uint64_t & Word = WriteTile(Y, X / 64)[Y % KTileSize];
+		const uint64_t Bit = uint64_t(1) << (X % 64);
+		if (Word & Bit) return false;
+
+		Word |= Bit;
+		return true;
+	}
+
+	/*!
+	* \brief Clear a case
+	* \param[in] X Position X
+	* \param[in] Y Position Y
+	*/
+	void Erase(const unsigned X, const unsigned Y) {
+		if (X >= m_Width || Y >= m_Height) return;
+
+		uint64_t * Tile = FindTile(Y, X / 64);
+		if (nullptr != Tile) Tile[Y % KTileSize] &= ~(uint64_t(1) << (X % 64));
+	}
+
+	/*!
+	* \brief Set the bits of one word of a line (64 cases starting at column Word * 64)
+	* \param[in] Line The line
+	* \param[in] Word Index of the word in the line
+	* \param[in] Bits Cases to set
+	*/
+	void SetWord(const unsigned Line, const unsigned Word, const uint64_t Bits) {
+		if (0 != Bits && Line < m_Height && Word < m_Stride) WriteTile(Line, Word)[Line % KTileSize] |= Bits;
+	}
+
+	/*!
+	* \brief Call Op(X, Y) on every set case, line by line (only the allocated tiles are read)
+	* \param[in] Op The function to call
+	*/
+	template <typename TOp>
+	void ForEachCase(TOp Op) const {
+		vector <pair <uint64_t, const uint64_t *>> Tiles;
+		Tiles.reserve(m_Tiles.size());
+		for (const auto & Tile : m_Tiles) Tiles.push_back(make_pair(Tile.first, Tile.second.m_lines));
+		sort(Tiles.begin(), Tiles.end());	/* par rangée de tuiles, puis par mot */
+
+		for (size_t First(0), Last; First < Tiles.size(); First = Last) {
+			const unsigned TileLine = unsigned(Tiles[First].first >> 32);
+			for (Last = First + 1; Last < Tiles.size() && unsigned(Tiles[Last].first >> 32) == TileLine; ++Last);
+
+			const unsigned EndLine = min(m_Height, (TileLine + 1) * KTileSize);
+			for (unsigned Y(TileLine * KTileSize); Y < EndLine; ++Y)
+				for (size_t i(First); i < Last; ++i) {
+					const unsigned Word = unsigned(Tiles[i].first);
+					for (uint64_t Bits(Tiles[i].second[Y % KTileSize]); 0 != Bits; Bits &= Bits - 1)
+						Op(Word * 64 + unsigned(__builtin_ctzll(Bits)), Y);
+				}
+		}
+	}
+
+	/*!
+	* \brief Set or clear a rectangle, clipped to the layer (clearing never allocates a tile)
+	* \param[in] Line First line of the rectangle
+	* \param[in] Column First column of the rectangle
+	* \param[in] Height Rectangle height
+	* \param[in] Width Rectangle width
+	* \param[in] IsSet Set the cases (true) or clear them (false)
+	*/
+	void FillRect(const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width, const bool IsSet) {
+		SWords Words;
+		if (!Clip(Line, Column, Height, Width, Words)) return;
+
+		for (unsigned First(Line); First < Words.m_lastLine; First = (First | (KTileSize - 1)) + 1) {
+			const unsigned Last = min(Words.m_lastLine, (First | (KTileSize - 1)) + 1);
+
+			for (unsigned Word(Words.m_first); Word <= Words.m_last; ++Word) {
+				uint64_t * Tile = (IsSet ? WriteTile(First, Word) : FindTile(First, Word));
+				if (nullptr == Tile) continue;
+
+				const uint64_t Mask = Words.Mask(Word);
+				for (unsigned Y(First); Y < Last; ++Y)
+					Tile[Y % KTileSize] = (IsSet ? Tile[Y % KTileSize] | Mask : Tile[Y % KTileSize] & ~Mask);
+			}
+		}
+	}
+
+	/*!
+	* \brief Check if a case of a rectangle is set
+	* \param[in] Line First line of the rectangle
+	* \param[in] Column First column of the rectangle
+	* \param[in] Height Rectangle height
+	* \param[in] Width Rectangle width
+	* \return True if at least one case is set
+	*/
+	bool AnyInRect(const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width) const {
+		if (1 == Height && 1 == Width) return Contains(Column, Line);	/* joueur de taille 1 : une seule case */
+
+		SWords Words;
+		if (!Clip(Line, Column, Height, Width, Words)) return false;
+
+		for (unsigned First(Line); First < Words.m_lastLine; First = (First | (KTileSize - 1)) + 1) {
+			const unsigned Last = min(Words.m_lastLine, (First | (KTileSize - 1)) + 1);
+
+			for (unsigned Word(Words.m_first); Word <= Words.m_last; ++Word) {
+				const uint64_t * Tile = FindTile(First, Word);
+				if (nullptr == Tile) continue;
+
+				const uint64_t Mask = Words.Mask(Word);
+				for (unsigned Y(First); Y < Last; ++Y)
+					if (Tile[Y % KTileSize] & Mask) return true;
+			}
+		}
+		return false;
+	}
+
+	/*!
+	* \brief Check if two layers of the same size have a common case in a rectangle
+	* \param[in] Other The other layer
+	* \param[in] Line First line of the rectangle
+	* \param[in] Column First column of the rectangle
+	* \param[in] Height Rectangle height
+	* \param[in] Width Rectangle width
+	* \return True if a case is set in both layers
+	*/
+	bool Intersects(const CBitBoard & Other, const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width) const {
+		SWords Words;
+		if (Other.m_Width != m_Width || Other.m_Height != m_Height || !Clip(Line, Column, Height, Width, Words)) return false;
+
+		for (unsigned First(Line); First < Words.m_lastLine; First = (First | (KTileSize - 1)) + 1) {
+			const unsigned Last = min(Words.m_lastLine, (First | (KTileSize - 1)) + 1);
+
+			for (unsigned Word(Words.m_first); Word <= Words.m_last; ++Word) {
+				const uint64_t * Tile = FindTile(First, Word);
+				const uint64_t * OtherTile = Other.FindTile(First, Word);
+				if (nullptr == Tile || nullptr == OtherTile) continue;
+
+				const uint64_t Mask = Words.Mask(Word);
+				for (unsigned Y(First); Y < Last; ++Y)
+					if (Tile[Y % KTileSize] & OtherTile[Y % KTileSize] & Mask) return true;
+			}
+		}
+		return false;
+	}
+
+	size_t NbTile() const { return m_Tiles.size(); }
+	size_t MemorySize() const { return m_Tiles.size() * sizeof(STile); }	/*!< octets des tuiles allouées */
+
+private:
+	/* Mots d'une ligne couverts par un rectangle, masques du premier et du dernier */
+	struct SWords {
+		unsigned m_lastLine;
+		unsigned m_first;
+		unsigned m_last;
+		uint64_t m_firstMask;
+		uint64_t m_lastMask;
+
+		uint64_t Mask(const unsigned Word) const {
+			return (Word == m_first ? m_firstMask : ~uint64_t(0)) & (Word == m_last ? m_lastMask : ~uint64_t(0));
+		}
+	};
+
+	/* Une tuile : 64 lignes d'un même mot */
+	struct STile {
+		uint64_t m_lines[KTileSize];
+	};
+
+	/* Dernière tuile cherchée pour une case du cache (m_tile nul : la tuile n'existe pas) */
+	struct SCachedTile {
+		uint64_t m_key;
+		uint64_t * m_tile;
+	};
+
+	static const unsigned KNbCachedTile = 16;
+	static const uint64_t KEmptyTile[KTileSize];
+
+	/*!
+	* \brief Clip a rectangle to the layer and get the words it covers on each line
+	* \return False if the clipped rectangle is empty
+	*/
+	bool Clip(const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width, SWords & Words) const {
+		const unsigned LastColumn = min(Column + Width, m_Width);
+		Words.m_lastLine = min(Line + Height, m_Height);
+		if (Line >= Words.m_lastLine || Column >= LastColumn) return false;
+
+		Words.m_first = Column / 64;
+		Words.m_last = (LastColumn - 1) / 64;
+		Words.m_firstMask = ~uint64_t(0) << (Column % 64);
+		Words.m_lastMask = ~uint64_t(0) >> (63 - (LastColumn - 1) % 64);
+		return true;
+	}
+
+	static uint64_t Key(const unsigned Line, const unsigned Word) {
+		return (uint64_t(Line >> KTileShift) << 32) | Word;
+	}
+
+	/* Case du cache d'une tuile : les tuiles voisines (ligne ou colonne) n'ont jamais la même */
+	static unsigned Slot(const unsigned Line, const unsigned Word) {
+		return (Word + 5 * (Line >> KTileShift)) % KNbCachedTile;
+	}
+
+	void ForgetTiles() {
+		for (SCachedTile & Cached : m_Cache) Cached = { ~uint64_t(0), nullptr };
+	}
+
+	uint64_t * FindTile(const unsigned Line, const unsigned Word) const {
+		SCachedTile & Cached = m_Cache[Slot(Line, Word)];
+		const uint64_t TileKey = Key(Line, Word);
+		if (TileKey == Cached.m_key) return Cached.m_tile;
+
+		const auto Found = m_Tiles.find(TileKey);
+		Cached.m_key = TileKey;
+		Cached.m_tile = (m_Tiles.end() == Found ? nullptr : const_cast <uint64_t *> (Found->second.m_lines));
+		return Cached.m_tile;
+	}
+
+	const uint64_t * ReadTile(const unsigned Line, const unsigned Word) const {
+		const uint64_t * Tile = FindTile(Line, Word);
+		return nullptr == Tile ? KEmptyTile : Tile;
+	}
+
+	uint64_t * WriteTile(const unsigned Line, const unsigned Word) {
+		uint64_t * Tile = FindTile(Line, Word);
+		if (nullptr != Tile) return Tile;
+
+		STile & New = m_Tiles[Key(Line, Word)];
+		fill(New.m_lines, New.m_lines + KTileSize, 0);
+		m_Cache[Slot(Line, Word)].m_tile = New.m_lines;
+		return New.m_lines;
+	}
+
+	unsigned m_Width;
+	unsigned m_Height;
+	unsigned m_Stride;	/*!< words per line */
+	unordered_map <uint64_t, STile> m_Tiles;	/*!< (rangée de tuiles, mot) -> tuile */
+	mutable SCachedTile m_Cache[KNbCachedTile];
+}; //CBitBoard
+
+const uint64_t CBitBoard::KEmptyTile[CBitBoard::KTileSize] = {};	/*!< shared tile of the cases never set */
 
 /**
 * \struct SPlayer
@@ -77,1040 +756,3792 @@ typedef struct {
 	char m_token;
 } SBonus;
 
+/**
+* \struct SRules
+* \brief Règles d'une partie.
+*
+* La structure SRules est une copie des options prise au début d'une partie : taille (m_sizeX, m_sizeY),
+* difficulté (m_difficult), densités d'obstacles et de bonus en pourcentage (m_obstacleDensity, m_bonusDensity),
+* tokens des bonus, des cases et des joueurs et touches de déplacement.
+* Une partie ne lit jamais les options globales, qui peuvent changer entre deux parties.
+*/
+typedef struct {
+	unsigned m_sizeX;
+	unsigned m_sizeY;
+	unsigned m_difficult;
+	unsigned m_obstacleDensity;
+	unsigned m_bonusDensity;
+	char m_bonusX;
+	char m_bonusY;
+	char m_bonusZ;
+	char m_mouvLeft;
+	char m_mouvTop;
+	char m_mouvBot;
+	char m_mouvRight;
+	char m_caseEmpty;
+	char m_caseObstacle;
+	char m_caseBorder;
+	char m_tokenPlayerX;
+	char m_tokenPlayerY;
+} SRules;
+
+/**
+* \class CPathFinder
+* \brief Recherche du plus court chemin (A*) du bot vers sa cible.
+*
+* Le chemin trouvé est gardé d'un tour à l'autre : il est prolongé quand la cible fait un pas
+* et n'est recalculé que si une de ses cases est devenue un obstacle ou s'il a trop dévié.
+* Les buffers (liste ouverte, cases visitées, parents) sont alloués une fois par taille de carte.
+*/
+class CPathFinder {
+public:
+	CPathFinder() : m_Width(0), m_Height(0), m_Generation(0), m_Next(0), m_Appended(0), m_Obstacles(nullptr), m_CaseObstacle(0), m_CaseBorder(0) {}
+
+	/*!
+	* \brief Get the next case the bot must go to
+	* \param[in] Map Game map
+	* \param[in] Obstacles Obstacles of the game
+	* \param[in] Rules Rules of the game
+	* \param[in] Bot The moving player (size 1)
+	* \param[in] Target The player to catch
+	* \param[out] NextX Position X of the next case
+	* \param[out] NextY Position Y of the next case
+	* \return False if Target can't be reached
+	*/
+	bool NextStep(const CMatrice & Map, const CBitBoard & Obstacles, const SRules & Rules, const SPlayer & Bot, const SPlayer & Target, unsigned & NextX, unsigned & NextY) {
+
+		if (Map.NbColumn() != m_Width || Map.NbLine() != m_Height) Resize(Map.NbColumn(), Map.NbLine());
+
+		m_Obstacles = &Obstacles;
+		m_CaseObstacle = Rules.m_caseObstacle;
+		m_CaseBorder = Rules.m_caseBorder;
+
+		const uint32_t BotCase = Bot.m_Y * m_Width + Bot.m_X;
+
+		/* Le bot a atteint la case prévue au tour précédent */
+		if (m_Next < m_Path.size() && m_Path[m_Next] == BotCase) ++m_Next;
+
+		if (!IsPathValid(Map, BotCase, Target) && !Plan(Map, BotCase, Target)) {
+			m_Path.clear();
+			m_Next = 0;
+			return false;
+		}
+
+		NextX = m_Path[m_Next] % m_Width;
+		NextY = m_Path[m_Next] / m_Width;
+		return true;
+	}
+
+	/*!
+	* \brief Forget the cached path (new game)
+	*/
+	void Clear() {
+		m_Path.clear();
+		m_Next = 0;
+	}
+
+private:
+	static const unsigned KMinAppended = 16;	/*!< pas de la cible toujours suivis sans recalculer le plus court chemin */
+
+	void Resize(const unsigned Width, const unsigned Height) {
+		m_Width = Width;
+		m_Height = Height;
+		m_Stamp.assign(size_t(Width) * Height, 0);
+		m_Cost.assign(size_t(Width) * Height, 0);
+		m_Parent.assign(size_t(Width) * Height, 0);
+		m_Generation = 0;
+		Clear();
+	}
+
+	/*!
+	* \brief Check if the bot can stand on a case (same rules as MovePlayer() / IsMovementForbidden())
+	*/
+	bool IsFree(const CMatrice & Map, const uint32_t Case) const {
+		const unsigned X = Case % m_Width, Y = Case / m_Width;
+
+		if (X < 1 || Y < 1 || X + 2 > m_Width || Y + 2 > m_Height) return false;
+		if (Map[Y][X] == m_CaseObstacle || Map[Y][X] == m_CaseBorder) return false;
+		return !m_Obstacles->Contains(X, Y);
+	}
+
+	static bool IsInTarget(const uint32_t Case, const unsigned Width, const SPlayer & Target) {
+		const unsigned X = Case % Width, Y = Case / Width;
+		return X >= Target.m_X && X < Target.m_X + Target.m_sizeX && Y >= Target.m_Y && Y < Target.m_Y + Target.m_sizeY;
+	}
+
+	static bool AreNeighbours(const uint32_t A, const uint32_t B, const unsigned Width) {
+		const unsigned Ax = A % Width, Ay = A / Width, Bx = B % Width, By = B / Width;
+		return (Ax == Bx && (Ay + 1 == By || By + 1 == Ay)) || (Ay == By && (Ax + 1 == Bx || Bx + 1 == Ax));
+	}
+
+	/*!
+	* \brief Check the cached path, following the target if it made one step
+	* \return False if the path must be planned again
+	*/
+	bool IsPathValid(const CMatrice & Map, const uint32_t BotCase, const SPlayer & Target) {
+
+		if (m_Next >= m_Path.size() || !AreNeighbours(BotCase, m_Path[m_Next], m_Width)) return false;
+
+		/* La cible est revenue sur le chemin : on le raccourcit */
+		for (size_t i(m_Next); i + 1 < m_Path.size(); ++i)
+			if (IsInTarget(m_Path[i], m_Width, Target)) {
+				m_Path.resize(i + 1);
+				break;
+			}
+
+		if (!IsInTarget(m_Path.back(), m_Width, Target)) {
+			const uint32_t Last = m_Path.back();
+			const uint32_t Neighbours[4] = { Last - m_Width, Last + m_Width, Last - 1, Last + 1 };
+			bool IsFollowed(false);
+
+			/* Au-delà, on recalcule : au plus un A* tous les quarts de chemin */
+			if (++m_Appended > max<size_t>(KMinAppended, (m_Path.size() - m_Next) / 4)) return false;
+
+			for (unsigned i(0); i < 4 && !IsFollowed; ++i) {
+				if (Neighbours[i] >= m_Stamp.size() || !AreNeighbours(Last, Neighbours[i], m_Width)) continue;
+				if (!IsInTarget(Neighbours[i], m_Width, Target) || !IsFree(Map, Neighbours[i])) continue;
+
+				m_Path.push_back(Neighbours[i]);
+				IsFollowed = true;
+			}
+
+			if (!IsFollowed) return false;
+		}
+
+		/* Une case du chemin a pu devenir un obstacle (bonus Z) */
+		for (size_t i(m_Next); i < m_Path.size(); ++i)
+			if (!IsFree(Map, m_Path[i])) return false;
+
+		return true;
+	}
+
+	/*!
+	* \brief A* (4 directions, Manhattan heuristic) from the bot to any case of the target
+	*
+	* Avec une heuristique de Manhattan, f augmente de 0, 1 ou 2 à chaque pas : la liste ouverte
+	* se réduit à 3 piles (une par valeur de f modulo 3), sans tas. Dépiler la pile de f courant
+	* donne la case la plus avancée d'abord.
+	* \return False if no path exists
+	*/
+	bool Plan(const CMatrice & Map, const uint32_t BotCase, const SPlayer & Target) {
+
+		if (0 == ++m_Generation) {	/* débordement : on remet les marques à zéro */
+			fill(m_Stamp.begin(), m_Stamp.end(), 0);
+			m_Generation = 1;
+		}
+
+		for (unsigned i(0); i < 3; ++i) m_Open[i].clear();
+		m_Path.clear();
+		m_Next = 0;
+		m_Appended = 0;
+
+		const SOpenCase Start = { 0, BotCase };
+		unsigned F = Heuristic(BotCase, Target);
+		size_t NbOpen(1);
+
+		m_Stamp[BotCase] = m_Generation;
+		m_Cost[BotCase] = 0;
+		m_Open[F % 3].push_back(Start);
+
+		while (0 != NbOpen) {
+			vector <SOpenCase> & Current = m_Open[F % 3];
+			if (Current.empty()) {
+				++F;
+				continue;
+			}
+
+			const SOpenCase Top = Current.back();
+			Current.pop_back();
+			--NbOpen;
+
+			if (Top.m_G != m_Cost[Top.m_Case]) continue;	/* un chemin plus court a été trouvé depuis */
+
+			const uint32_t Case = Top.m_Case;
+
+			if (Case != BotCase && IsInTarget(Case, m_Width, Target)) {
+				for (uint32_t Step(Case); Step != BotCase; Step = m_Parent[Step]) m_Path.push_back(Step);
+				reverse(m_Path.begin(), m_Path.end());
+				return true;
+			}
+
+			const unsigned X = Case % m_Width, Y = Case / m_Width;
+			const bool IsValid[4] = { Y > 0, Y + 1 < m_Height, X > 0, X + 1 < m_Width };
+			const uint32_t Neighbours[4] = { Case - m_Width, Case + m_Width, Case - 1, Case + 1 };
+
+			for (unsigned i(0); i < 4; ++i) {
+				if (!IsValid[i]) continue;
+
+				const uint32_t Neighbour = Neighbours[i];
+				const SOpenCase Open = { Top.m_G + 1, Neighbour };
+
+				if (m_Stamp[Neighbour] == m_Generation && m_Cost[Neighbour] <= Open.m_G) continue;
+				if (!IsFree(Map, Neighbour)) continue;
+
+				m_Stamp[Neighbour] = m_Generation;
+				m_Cost[Neighbour] = Open.m_G;
+				m_Parent[Neighbour] = Case;
+				m_Open[(Open.m_G + Heuristic(Neighbour, Target)) % 3].push_back(Open);
+				++NbOpen;
+			}
+		}
+
+		return false;
+	}
+
+	unsigned Heuristic(const uint32_t Case, const SPlayer & Target) const {
+		const unsigned X = Case % m_Width, Y = Case / m_Width;
+		const unsigned Dx = X < Target.m_X ? Target.m_X - X : (X >= Target.m_X + Target.m_sizeX ? X - (Target.m_X + Target.m_sizeX - 1) : 0);
+		const unsigned Dy = Y < Target.m_Y ? Target.m_Y - Y : (Y >= Target.m_Y + Target.m_sizeY ? Y - (Target.m_Y + Target.m_sizeY - 1) : 0);
+		return Dx + Dy;
+	}
+
+	typedef struct {
+		uint32_t m_G;	/*!< length from the bot */
+		uint32_t m_Case;
+	} SOpenCase;
+
+	unsigned m_Width;
+	unsigned m_Height;
+	vector <uint32_t> m_Stamp;	/*!< case visited if equal to m_Generation */
+	uint32_t m_Generation;	/*!< current search number */
+	vector <uint32_t> m_Cost;	/*!< length of the best known path from the bot */
+	vector <uint32_t> m_Parent;	/*!< previous case on the best known path */
+	vector <SOpenCase> m_Open[3];	/*!< open list, one stack by value of f modulo 3 */
+	vector <uint32_t> m_Path;	/*!< cached path, from the bot to the target */
+	size_t m_Next;	/*!< index in m_Path of the next case to reach */
+	unsigned m_Appended;	/*!< target steps followed since the last planning */
+	const CBitBoard * m_Obstacles;	/*!< obstacles of the game, during NextStep() */
+	char m_CaseObstacle;	/*!< obstacle token, during NextStep() */
+	char m_CaseBorder;	/*!< border token, during NextStep() */
+}; //CPathFinder
+
+/**
+* \struct SMatch
+* \brief Etat d'une partie.
+*
+* La structure SMatch regroupe tout ce qu'une partie lit ou modifie : ses règles (m_rules), les deux joueurs,
+* les obstacles (m_obstacles), un calque par type d'entité (obstacles, bonus, chaque joueur),
+* le log, son générateur aléatoire et le chemin du bot (m_botPath).
+* Les fonctions de jeu travaillent sur une instance explicite : plusieurs parties peuvent tourner en parallèle.
+*/
+typedef struct {
+	SRules m_rules;
+	SPlayer m_playerX;
+	SPlayer m_playerY;
+	vector <SObstacle> m_obstacles;
+	CBitBoard m_obstacleLayer;
+	CBitBoard m_bonusLayer;
+	CBitBoard m_playerLayerX;
+	CBitBoard m_playerLayerY;
+	string m_log;
+	CRandom m_random;
+	CPathFinder m_botPath;
+} SMatch;
+
+/**
+* \struct SReplay
+* \brief Enregistrement d'une partie.
+*
+* La structure SReplay contient de quoi rejouer une partie à l'identique : la graine (m_seed) et l'état du générateur
+* aléatoire au premier coup (m_state, consommé ensuite par les bonus), les règles, les joueurs, la carte et les obstacles
+* de départ, puis les coups (m_moves : un caractère par coup, joueurs alternés en commençant par le premier,
+* '.' si le joueur n'a pas bougé). Le résultat (m_winner, m_nbTour, m_scoreX, m_scoreY) sert à vérifier le rejeu.
+*/
+typedef struct {
+	uint64_t m_seed;
+	uint64_t m_state[4];
+	SRules m_rules;
+	SPlayer m_playerX;
+	SPlayer m_playerY;
+	CMatrice m_map;
+	vector <SObstacle> m_obstacles;
+	string m_moves;
+	char m_winner;
+	unsigned m_nbTour;
+	int m_scoreX;
+	int m_scoreY;
+} SReplay;
+
+
+
+/*COULEURS BASIQUE*/
+
+// !alias to the reset color display
+const string KReset("0");
+// !alias to the black color 
+const string KNoir("30");
+// !alias to the red color 
+const string KRouge("31");
+// !alias to the green color 
+const string KVert("32");
+// !alias to the yellow color 
+const string KJaune("33");
+// !alias to the blue color 
+const string KBleu("34");
+// !alias to the magenta color 
+const string KMagenta("35");
+// !alias to the cyan color 
+const string KCyan("36");
+// !alias to the black color 
+const string KUnderLine("4");
+// !alias to underline some text 
+const string KBold("1");
+// !alias to bold some text
+const string KOverLine("53");
+// !alias to overline some text
+
+/*HIGHTLIGHT*/
+const string KHNoir("40");
+// !alias to the black highlight 
+const string KHRouge("41");
+// !alias to the red highlight
+const string KHVert("42");
+// !alias to the green highlight
+const string KHJaune("43");
+// !alias to the yellow highlight
+const string KHBleu("44");
+// !alias to the blue highlight
+const string KHMagenta("45");
+// !alias to the magenta highlight
+const string KHCyan("46");
+// !alias to the cyan highlight
+const string KHGris("47");
+// !alias to the grey highlight
+
+/* VARIABLES DE CONFIGURATION */
+
+// !alias to the console size
+struct winsize size;
+
+map <string, string> TitleCache;	/*!< titles already read, by file name */
+const string KReplayFile("./last.replay");	/*!< replay of the last game played in the console */
+const string KOptionFile("./options.cfg");	/*!< options saved from the option screen, read at startup */
+const char KKeyRestart('r');	/*!< Key restarting the game on a new map */
+const char KKeyRetry('R');	/*!< Key restarting the game on the same map (same seed) */
+const char KKeyMinimap('m');	/*!< Key switching between the board around the player and the minimap */
+const unsigned KInfoHeight(16);	/*!< console lines kept under the board for the game infos (rules not included) */
+const string KMapDir("./map");	/*!< directory of the maps (./map/MyMap_<Name>.map or .cmap) */
+const string KMapCatalogFile("./map/.catalog");	/*!< index of the maps : size and tokens of each map at its modification date */
+const unsigned KMapPageSize(10);	/*!< maps listed per page */
+const uint64_t KMaxMapCase(uint64_t(1) << 28);	/*!< biggest map accepted by the decoders (cases) */
+const unsigned KMaxMapSize(16383);	/*!< biggest KSizeX / KSizeY : the (size + 1) x (size + 1) map, border included, stays within KMaxMapCase */
+const unsigned KMaxChunkedSide(1u << 20);	/*!< biggest side of a chunked map : its border alone takes 4 * side / 64 tiles */
+static_assert(uint64_t(KMaxMapSize + 1) * (KMaxMapSize + 1) <= KMaxMapCase, "KMaxMapSize : la carte dépasserait KMaxMapCase");
+SMatch Game;	/*!< game played in the console */
+string & SLog = Game.m_log;  /*!< log string */
+
+
+bool BShowRules;	/*!< Showing rules or not */
+bool BShowHistory;	/*!< Showing history or not  */
+
+unsigned KSizeY;	/*!< Matrix size (Y axe) */
+unsigned KSizeX;	/*!< Matrix size (X axe) */
+unsigned KDifficult;	/*!< Difficulty */
+unsigned KObstacleDensity;	/*!< Percentage of the cases filled with obstacles (0 : obstacles placed by difficulty) */
+unsigned KBonusDensity;	/*!< Percentage of the cases filled with bonus (0 : bonus placed by difficulty) */
+uint64_t KSeed;	/*!< Random seed (0 : new seed for each game) */
+unsigned KBotDelay;	/*!< Time between two bot moves in real time (milliseconds) */
+bool BRealTime;	/*!< The bot moves on a clock instead of after each player move */
+
+char BonusY;	/*!< Bonus Y token */
+char BonusX;	/*!< Bonus X token */
+char BonusZ;	/*!< Bonus Z token */
+char CMouvLeft;	/*!< Key associed to left movement */
+char CMouvTop;	/*!< Key associed to top movement */
+char CMouvBot;	/*!< Key associed to bot movement */
+char CMouvRight;	/*!< Key associed to rigght movement */
+char CaseEmpty;	/*!< Empty case token */
+char CaseObstacle;	/*!< Obstacle case token */
+char CaseBorder;	/*!< Border case token */
+char TokenPlayerX;	/*!< First player token */
+char TokenPlayerY;	/*!< Second player token */
+
+SPlayer & PlayerX = Game.m_playerX;	/*!< First player */
+SPlayer & PlayerY = Game.m_playerY;	/*!< First player  */
+
+/*! Screens of the console game, chained by the loop of main() */
+enum EScreen { KScreenMenu, KScreenSolo, KScreenMulti, KScreenEditor, KScreenOption, KScreenQuit };
+
+void DisplayLog();
+EScreen DisplayMenu();
+EScreen DisplaySoloIA();
+void DisplayHistory();
+EScreen DisplayEditor();
+void DisplayInfos(const SPlayer & Player);
+template <typename TMatrice>
+void GenerateStaticObject(SMatch & Match, TMatrice & Map, unsigned & Difficulty, const unsigned & NbObs = 0, const unsigned & NbBonus = 0);
+bool GetEnteredEdge(const SRules & Rules, const SPlayer & Player, const char Move, unsigned & Line, unsigned & Column, unsigned & Height, unsigned & Width);
+template <typename TMatrice>
+void FillPlayerRect(SMatch & Match, TMatrice & Matrice, const SPlayer & Player, const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width, const bool IsPlayer);
+bool ReadFile(const string & File, string & Content);
+bool WriteFileAtomic(const string & File, vector <struct iovec> & Parts);
+bool WriteFileAtomic(const string & File, const function <bool (vector <struct iovec> &)> & NextParts);
+bool SetConfig(const string & Name, const string & Value);
+void StartReplay(SReplay & Replay, const SMatch & Match, const CMatrice & Map);
+void RecordMove(SReplay & Replay, const SRules & Rules, const bool IsPlayerX, const int Move);
+
+//SCREEN - INITS
+
+/**
+* \class CFrame
+* \brief Composition d'un écran complet dans un seul buffer.
+*
+* Pendant une frame (Begin() ... End()), cout écrit dans un buffer préalloué au lieu de la console :
+* les endl/flush ne provoquent plus d'écriture. End() envoie tout l'écran en un seul write().
+*/
+class CFrame : public streambuf {
+public:
+	explicit CFrame(const size_t Capacity = 1 << 16) : m_Previous(nullptr) { m_Buffer.reserve(Capacity); }
+
+	/*!
+	* \brief Start composing a frame : cout is redirected to the buffer
+	*/
+	void Begin() {
+		cout.flush();
+		m_Buffer.clear();
+		if (nullptr == m_Previous) m_Previous = cout.rdbuf(this);
+	}
+
+	/*!
+	* \brief Send the frame to the console in one write() and restore cout
+	* \return Number of bytes written
+	*/
+	size_t End() {
+		if (nullptr != m_Previous) {
+			cout.rdbuf(m_Previous);
+			m_Previous = nullptr;
+		}
+
+		size_t Written(0);
+		while (Written < m_Buffer.size()) {
+			ssize_t Ret = write(STDOUT_FILENO, m_Buffer.data() + Written, m_Buffer.size() - Written);
+			if (Ret < 0 && EINTR == errno) continue;
+			if (Ret <= 0) break;
+			Written += Ret;
+		}
+
+		m_Buffer.clear();
+		return Written;
+	}
+
+protected:
+	int_type overflow(int_type Ch) override {
+		if (!traits_type::eq_int_type(Ch, traits_type::eof())) m_Buffer.push_back(traits_type::to_char_type(Ch));
+		return traits_type::not_eof(Ch);
+	}
+
+	streamsize xsputn(const char * Str, streamsize Count) override {
+		m_Buffer.insert(m_Buffer.end(), Str, Str + Count);
+		return Count;
+	}
+
+	int sync() override { return 0; }	/* endl ne vide pas la frame */
+
+private:
+	vector <char> m_Buffer;	/*!< the frame being composed */
+	streambuf * m_Previous;	/*!< cout buffer while a frame is composed */
+}; //CFrame
+
+CFrame Frame;	/*!< frame of the current screen */
+
+const unsigned KFrameDelay = 16;	/*!< minimum time between two frames (milliseconds) */
+
+/**
+* \class CEventLoop
+* \brief Boucle d'événements d'une partie.
+*
+* Une seule session curses par partie (Start() ... Stop()) : le terminal n'est plus réinitialisé à chaque tour.
+* Wait() attend avec poll() une touche sur stdin ou l'échéance d'un minuteur : la frame, au plus une toutes
+* les KFrameDelay ms et seulement si l'écran a changé (Invalidate()), et le tick du bot en temps réel.
+* Les touches sont traitées dès leur arrivée, avant la frame : plusieurs touches rapides ne donnent qu'une frame.
+*/
+class CEventLoop {
+public:
+	enum { KEventKey, KEventFrame, KEventBot };
+
+	CEventLoop() : m_IsStarted(false), m_IsDirty(false), m_BotDelay(0) {}
+	~CEventLoop() { Stop(); }
+
+	/*!
+	* \brief Start the curses session of a game
+	* \param[in] BotDelay Time between two bot ticks (milliseconds, 0 : no bot tick)
+	*/
+	void Start(const unsigned BotDelay = 0) {
+		initscr();
+		raw();
+		noecho();
+		keypad(stdscr, TRUE);
+		nodelay(stdscr, TRUE);	/* getch() ne bloque plus : l'attente se fait dans poll() */
+		leaveok(stdscr, TRUE);
+		refresh();
+		ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
+
+		m_IsStarted = true;
+		m_IsDirty = true;
+		m_BotDelay = BotDelay;
+		m_NextFrame = chrono::steady_clock::now();
+		m_NextBot = m_NextFrame + chrono::milliseconds(BotDelay);
+		m_Keys.clear();
+	}
+
+	/*!
+	* \brief End the curses session (back to the normal screen)
+	*/
+	void Stop() {
+		if (!m_IsStarted) return;
+		endwin();
+		m_IsStarted = false;
+	}
+
+	/*!
+	* \brief The screen changed : a frame will be sent at the next frame tick
+	*/
+	void Invalidate() { m_IsDirty = true; }
+
+	/*!
+	* \brief Wait for the next event
+	* \param[out] Key The pressed key (KEventKey only)
+	* \return KEventKey, KEventFrame or KEventBot
+	*/
+	int Wait(int & Key) {
+
+		while (true) {
+			ReadKeys();
+
+			if (!m_Keys.empty()) {
+				Key = m_Keys.front();
+				m_Keys.erase(m_Keys.begin());
+				if (KEY_RESIZE == Key) ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
+				return KEventKey;
+			}
+
+			const chrono::steady_clock::time_point Now = chrono::steady_clock::now();
+
+			if (m_IsDirty && Now >= m_NextFrame) {
+				m_IsDirty = false;
+				m_NextFrame = Now + chrono::milliseconds(KFrameDelay);
+				return KEventFrame;
+			}
+
+			if (0 != m_BotDelay && Now >= m_NextBot) {
+				m_NextBot += chrono::milliseconds(m_BotDelay);
+				if (m_NextBot < Now) m_NextBot = Now + chrono::milliseconds(m_BotDelay);	/* pas de rattrapage après une pause */
+				return KEventBot;
+			}
+
+			int Timeout = -1;
+			if (m_IsDirty) Timeout = TimeoutTo(m_NextFrame, Now);
+			if (0 != m_BotDelay && (-1 == Timeout || TimeoutTo(m_NextBot, Now) < Timeout)) Timeout = TimeoutTo(m_NextBot, Now);
+
+			pollfd Input = { STDIN_FILENO, POLLIN, 0 };
+			poll(&Input, 1, Timeout);	/* EINTR (SIGWINCH) : KEY_RESIZE est lu au tour suivant */
+		}
+	}
+
+private:
+	static int TimeoutTo(const chrono::steady_clock::time_point & Deadline, const chrono::steady_clock::time_point & Now) {
+		return int(chrono::duration_cast <chrono::milliseconds> (Deadline - Now).count()) + 1;
+	}
+
+	/*!
+	* \brief Read every key already typed
+	*/
+	void ReadKeys() {
+		for (int Key = getch(); ERR != Key; Key = getch()) m_Keys.push_back(Key);
+	}
+
+	bool m_IsStarted;
+	bool m_IsDirty;	/*!< a frame must be sent */
+	unsigned m_BotDelay;
+	chrono::steady_clock::time_point m_NextFrame;	/*!< earliest time of the next frame */
+	chrono::steady_clock::time_point m_NextBot;	/*!< time of the next bot tick */
+	vector <int> m_Keys;	/*!< keys read but not handled yet */
+}; //CEventLoop
+
+/*!
+* \brief Print color
+* \param[in] Coul Color wanted
+* \param[in] Hightlight Optional highlight wanted
+*/
+void Couleur(const string & Coul, const string & Hightlight = "") {
+
+	if (Hightlight != "")
+		cout << "\033[34m\033[" << Hightlight << "m";
+	else
+		cout << "\033[" << Coul << "m";
+
+
+} //Couleur()
+
+/*!
+* \brief Ask player maximum round
+* \return Return the maximum round
+*/
+unsigned GetTourMax() {
+	unsigned Nbround;
+
+	Couleur(KCyan);
+	cout << endl << "[?] Entrez le nombre de rounds : ";
+
+	while (!(cin >> Nbround)) {
+		Couleur(KRouge);
+		cout << "\n\r[!] Le nombre de tour est incorrect. Veillez réessayer : \n\r";
+		cin.clear();
+		break;
+
+	}
+	Couleur(KReset);
+
+	return Nbround;
+} //GetTourMax()
+
+
+/*!
+* \brief Set text to the middle screen
+*/
+
+void SetTextMiddle() {
+	cout << setw(round(size.ws_col / 2));
+
+} //SetTextMiddle()
+
+ /*!
+ * \brief Clear console
+ */
+
+void ClearScreen() {
+	cout << "\033[H\033[2J";
+}//ClearScreen()
+
+  /*!
+  * \brief PrintLines
+  * \param[in] LineNumber Number of line to display
+  */
+void PrintLines(const unsigned & LineNumber) {
+	for (unsigned i(0); i < LineNumber; ++i) cout << endl;
+} //PrintLines
+
+  /*!
+  * \brief Wait until the player presses Enter
+  */
+void WaitForEnter() {
+
+	Couleur(KCyan);
+	cout << "\n\r[?] Appuyez sur Entrée pour revenir au menu...";
+	Couleur(KReset);
+	cout << flush;
+
+	cin.clear();
+	cin.ignore(numeric_limits<streamsize>::max(), '\n');	/* fin de la dernière saisie */
+	cin.get();
+} //WaitForEnter()
+  /*!
+  * \brief Convert string to bool
+  * \param[in] Chaine String to convert
+  * \return True if Chaine equal to "true"
+  */
+bool StrToBool(const string & Chaine) {
+	return(Chaine == "true" ? true : false);
+} //StrToBool()
+
+/*!
+* \brief Get a title, read from disk only on its first use
+* \param[in] FileName File to read in (in asciititle/)
+* \return The title, each line ended by '\n' (empty line if the file is missing)
+*/
+const string & GetTitle(const string & FileName) {
+
+	map <string, string>::iterator It = TitleCache.find(FileName);
+	if (It != TitleCache.end()) return It->second;
+
+	string StrTitle;
+	string StrDir = "asciititle";
+	ReadFile(StrDir + '/' + FileName, StrTitle);
+	StrTitle += '\n';
+
+	return TitleCache[FileName] = StrTitle;
+}//GetTitle()
+
+/*!
+* \brief Show title from file
+* \param[in] FileName File to read in
+* \param[in] Clear Clear or not the console (optional)
+* \return Number of lines printed
+*/
+unsigned ShowTitle(const string & FileName, const bool Clear = true) {
+
+	ClearScreen();
+	const string & StrTitle = GetTitle(FileName);
+
+	PrintLines(1);
+	cout << StrTitle << flush;
+
+	return 1 + count(StrTitle.begin(), StrTitle.end(), '\n');
+}//ShowTitle()
+
+// OPTIONS
+
+/* Type de la variable d'une option : un caractère, un nombre, une graine (64 bits) ou un booléen */
+enum EOptionType { KOptionToken, KOptionUnsigned, KOptionSeed, KOptionBool };
+
+/**
+* \struct SOption
+* \brief Une option du jeu.
+*
+* La structure SOption associe le nom d'une option (m_name) à sa variable globale (m_value), lue et écrite
+* selon son type (m_type), avec sa valeur par défaut (m_default) et, pour un nombre, ses valeurs minimale (m_min) et maximale (m_max).
+*/
+typedef struct {
+	const char * m_name;
+	EOptionType m_type;
+	void * m_value;
+	const char * m_default;
+	uint64_t m_min;
+	uint64_t m_max;
+} SOption;
+
+/* Toutes les options : une ligne par option (la variable globale est déclarée plus haut) ; une carte fait au moins 4x4 pour placer les deux joueurs,
+et au plus KMaxMapSize de côté pour que GenerateGameMap() puisse l'allouer */
+constexpr SOption KOptions[] = {
+	{ "CaseEmpty", KOptionToken, &CaseEmpty, ".", 0, 0 },
+	{ "TokenPlayerX", KOptionToken, &TokenPlayerX, "X", 0, 0 },
+	{ "TokenPlayerY", KOptionToken, &TokenPlayerY, "O", 0, 0 },
+	{ "KSizeX", KOptionUnsigned, &KSizeX, "10", 4, KMaxMapSize },
+	{ "KSizeY", KOptionUnsigned, &KSizeY, "10", 4, KMaxMapSize },
+	{ "KDifficult", KOptionUnsigned, &KDifficult, "1", 1, 2 },
+	{ "BShowRules", KOptionBool, &BShowRules, "true", 0, 0 },
+	{ "BShowHistory", KOptionBool, &BShowHistory, "true", 0, 0 },
+	{ "KSeed", KOptionSeed, &KSeed, "0", 0, UINT64_MAX },
+	{ "BRealTime", KOptionBool, &BRealTime, "false", 0, 0 },
+	{ "KBotDelay", KOptionUnsigned, &KBotDelay, "250", 0, UINT_MAX },
+	{ "KObstacleDensity", KOptionUnsigned, &KObstacleDensity, "0", 0, 100 },
+	{ "KBonusDensity", KOptionUnsigned, &KBonusDensity, "0", 0, 100 },
+	{ "CMouvLeft", KOptionToken, &CMouvLeft, "q", 0, 0 },
+	{ "CMouvTop", KOptionToken, &CMouvTop, "z", 0, 0 },
+	{ "CMouvBot", KOptionToken, &CMouvBot, "s", 0, 0 },
+	{ "CMouvRight", KOptionToken, &CMouvRight, "d", 0, 0 },
+};
+constexpr unsigned KNbOption = sizeof(KOptions) / sizeof(KOptions[0]);	/*!< number of options */
+constexpr unsigned KOptionSlots = 64;	/*!< size of the option hash table */
+
+/*!
+* \brief Hash an option name (FNV-1a), at compile time for the names of KOptions
+* \param[in] Name The option name
+* \param[in] Hash Hash of the characters already read
+* \return The hash
+*/
+constexpr uint32_t HashOptionName(const char * Name, const uint32_t Hash = 2166136261u) {
+	return '\0' == *Name ? Hash : HashOptionName(Name + 1, (Hash ^ uint8_t(*Name)) * 16777619u);
+}//HashOptionName()
+
+/*!
+* \brief Check at compile time that two options never share a slot of the hash table
+* \return True if the hash is perfect on KOptions
+*/
+constexpr bool IsOptionHashPerfect(const unsigned First = 0, const unsigned Second = 1) {
+	return First >= KNbOption ? true
+		: Second >= KNbOption ? IsOptionHashPerfect(First + 1, First + 2)
+		: HashOptionName(KOptions[First].m_name) % KOptionSlots != HashOptionName(KOptions[Second].m_name) % KOptionSlots
+			&& IsOptionHashPerfect(First, Second + 1);
+}//IsOptionHashPerfect()
+
+static_assert(IsOptionHashPerfect(), "Deux options ont la même case dans OptionSlots : changez KOptionSlots");
+
+unsigned char OptionSlots[KOptionSlots];	/*!< index + 1 of the option of each slot (0 : no option), filled by InitOptions() */
+
+/*!
+* \brief Find an option by its name (one slot of the hash table is read)
+* \param[in] Name The option name
+* \return The option (nullptr if Name is not an option)
+*/
+const SOption * FindOption(const string & Name) {
+	const unsigned char Slot = OptionSlots[HashOptionName(Name.c_str()) % KOptionSlots];
+	if (0 == Slot || Name != KOptions[Slot - 1].m_name) return nullptr;
+	return &KOptions[Slot - 1];
+}//FindOption()
+
+/*!
+* \brief Get the current value of an option, as written in the config file
+* \param[in] Option The option
+* \return The value
+*/
+string GetOptionValue(const SOption & Option) {
+	switch (Option.m_type) {
+	case KOptionToken: return string(1, *static_cast <const char *> (Option.m_value));
+	case KOptionUnsigned: return to_string(*static_cast <const unsigned *> (Option.m_value));
+	case KOptionSeed: return to_string(*static_cast <const uint64_t *> (Option.m_value));
+	default: return *static_cast <const bool *> (Option.m_value) ? "true" : "false";
+	}
+}//GetOptionValue()
+
+/*!
+* \brief Initiate defaults options
+*/
+void InitOptions() {
+
+	/*
+	All configs go in KOptions (with their DEFAULT value) AND in header part (simple declaration)
+	*/
+
+	fill(OptionSlots, OptionSlots + KOptionSlots, 0);
+	for (unsigned i(0); i < KNbOption; ++i) {
+		OptionSlots[HashOptionName(KOptions[i].m_name) % KOptionSlots] = i + 1;
+		SetConfig(KOptions[i].m_name, KOptions[i].m_default);
+	}
+
+	BonusX = 'W';
+	BonusY = 'V';
+	BonusZ = 'U';
+	CaseObstacle = '#';
+	CaseBorder = '#';
+
+} //InitOptions()
+
+/*!
+* \brief Modify a specific config
+* \param[in] Name The configuration name
+* \param[in] Value The new value to affect
+* \return False (and SLog filled) if Name is not an option or Value is not valid for it
+*/
+bool SetConfig(const string & Name, const string & Value) {
+
+	const SOption * Option = FindOption(Name);
+	if (nullptr == Option) {
+		SLog += "\n\r[!] Option inconnue : " + Name;
+		return false;
+	}
+
+	if (KOptionToken == Option->m_type && 1 == Value.size()) {
+		*static_cast <char *> (Option->m_value) = Value[0];
+		return true;
+	}
+
+	if (KOptionBool == Option->m_type && ("true" == Value || "false" == Value)) {
+		*static_cast <bool *> (Option->m_value) = StrToBool(Value);
+		return true;
+	}
+
+	if ((KOptionUnsigned == Option->m_type || KOptionSeed == Option->m_type) && !Value.empty() && Value.size() < 21
+		&& string::npos == Value.find_first_not_of("0123456789")) {
+		errno = 0;
+		const unsigned long long Number = strtoull(Value.c_str(), nullptr, 10);
+		if (0 == errno && Number >= Option->m_min && Number <= Option->m_max) {
+			if (KOptionSeed == Option->m_type) *static_cast <uint64_t *> (Option->m_value) = Number;
+			else *static_cast <unsigned *> (Option->m_value) = unsigned(Number);
+			return true;
+		}
+	}
+
+	SLog += "\n\r[!] Valeur invalide pour " + Name + " : '" + Value + "'";
+	return false;
+} //SetConfig();
+
+/*!
+* \brief Read the config file once and apply each line "Name=Value" ('#' : comment)
+* \param[in] File The config file
+* \return False (and SLog filled) if a line is not valid (the other lines are applied)
+*/
+bool LoadOptions(const string & File = KOptionFile) {
+
+	string Content;
+	if (!ReadFile(File, Content)) return true;	/* pas encore d'options enregistrées */
+
+	bool IsValid(true);
+	for (size_t Begin(0), End; Begin < Content.size(); Begin = End + 1) {
+		End = Content.find('\n', Begin);
+		if (string::npos == End) End = Content.size();
+
+		string Line = Content.substr(Begin, End - Begin);
+		if (!Line.empty() && '\r' == Line.back()) Line.pop_back();	/* fichier écrit sous Windows (CRLF) */
+		const size_t Equal = Line.find('=');
+		if (Line.empty() || '#' == Line[0]) continue;
+
+		if (string::npos == Equal) {
+			SLog += "\n\r[!] Ligne invalide dans " + File + " : " + Line;
+			IsValid = false;
+		}
+		else IsValid = SetConfig(Line.substr(0, Equal), Line.substr(Equal + 1)) && IsValid;
+	}
+	return IsValid;
+} //LoadOptions()
+
+/*!
+* \brief Save the current value of an option into the config file (the other lines are kept)
+* \param[in] Name The option name
+* \param[in] File The config file
+* \return False if the config file can't be written
+*/
+bool SaveOption(const string & Name, const string & File = KOptionFile) {
+
+	const SOption * Option = FindOption(Name);
+	if (nullptr == Option) return false;
+
+	string Content, Saved;
+	const string Line = Name + '=' + GetOptionValue(*Option) + '\n';
+	bool IsReplaced(false);
+
+	ReadFile(File, Content);
+	for (size_t Begin(0), End; Begin < Content.size(); Begin = End + 1) {
+		End = Content.find('\n', Begin);
+		if (string::npos == End) End = Content.size();
+
+		if (0 == Content.compare(Begin, Name.size() + 1, Name + '=')) {
+			Saved += Line;
+			IsReplaced = true;
+		}
+		else Saved += Content.substr(Begin, End - Begin) + '\n';
+	}
+	if (!IsReplaced) Saved += Line;
+
+	vector <struct iovec> Parts(1, { &Saved[0], Saved.size() });
+	return WriteFileAtomic(File, Parts);
+} //SaveOption()
+
+/*!
+* \brief Get the rules of a new game from the current options
+* \return The rules
+*/
+
+SRules GetRules() {
+
+	SRules Rules;
+
+	Rules.m_sizeX = KSizeX;
+	Rules.m_sizeY = KSizeY;
+	Rules.m_difficult = KDifficult;
+	Rules.m_obstacleDensity = KObstacleDensity;
+	Rules.m_bonusDensity = KBonusDensity;
+	Rules.m_bonusX = BonusX;
+	Rules.m_bonusY = BonusY;
+	Rules.m_bonusZ = BonusZ;
+	Rules.m_mouvLeft = CMouvLeft;
+	Rules.m_mouvTop = CMouvTop;
+	Rules.m_mouvBot = CMouvBot;
+	Rules.m_mouvRight = CMouvRight;
+	Rules.m_caseEmpty = CaseEmpty;
+	Rules.m_caseObstacle = CaseObstacle;
+	Rules.m_caseBorder = CaseBorder;
+	Rules.m_tokenPlayerX = TokenPlayerX;
+	Rules.m_tokenPlayerY = TokenPlayerY;
+
+	return Rules;
+}//GetRules()
+
+/*!
+* \brief Start a new game : set its rules, seed its random engine and forget its obstacles and bot path
+* \param[in] Match The game
+* \param[in] Rules Rules of the game
+* \param[in] Seed The game seed (0 : a new seed)
+* \return The seed used
+*/
+
+uint64_t InitMatch(SMatch & Match, const SRules & Rules, uint64_t Seed) {
+
+	if (0 == Seed) {
+		random_device Random;
+		Seed = (uint64_t(Random()) << 32) | Random();
+	}
+
+	Match.m_rules = Rules;
+	Match.m_random.SetSeed(Seed);
+	Match.m_obstacles.clear();
+	Match.m_obstacleLayer.Reset(0, 0);
+	Match.m_bonusLayer.Reset(0, 0);
+	Match.m_playerLayerX.Reset(0, 0);
+	Match.m_playerLayerY.Reset(0, 0);
+	Match.m_botPath.Clear();
+
+	return Seed;
+}//InitMatch()
+
+// MATRICE
+
+/*!
+* \brief Read a whole file at once
+* \param[in] File File to read in
+* \param[out] Content The file content
+* \return False if the file can't be read
+*/
+bool ReadFile(const string & File, string & Content) {
+
+	const int Fd = open(File.c_str(), O_RDONLY);
+	if (Fd < 0) return false;
+
+	struct stat Stat;
+	if (fstat(Fd, &Stat) < 0) {
+		close(Fd);
+		return false;
+	}
+
+	Content.resize(Stat.st_size);
+	size_t Readed(0);
+
+	while (Readed < Content.size()) {
+		ssize_t Ret = read(Fd, &Content[Readed], Content.size() - Readed);
+		if (Ret < 0 && EINTR == errno) continue;
+		if (Ret <= 0) break;
+		Readed += Ret;
+	}
+
+	close(Fd);
+	Content.resize(Readed);
+	return true;
+}//ReadFile
+
+/*!
+* \brief Write several buffers into a file descriptor, without copying them (writev)
+* \param[in] Fd The file descriptor
+* \param[in] Parts The buffers, in order (modified by the partial writes)
+* \return False if a write failed
+*/
+bool WriteParts(const int Fd, vector <struct iovec> & Parts) {
+
+	struct iovec * Part = Parts.data();
+	struct iovec * const End = Part + Parts.size();
+
+	while (Part != End) {
+		ssize_t Ret = writev(Fd, Part, int(min<ptrdiff_t>(End - Part, IOV_MAX)));
+		if (Ret < 0 && EINTR == errno) continue;
+		if (Ret < 0) return false;
+
+		/* Écriture partielle : on saute les buffers écrits et on avance dans le premier qui ne l'est pas */
+		for (; Part != End && size_t(Ret) >= Part->iov_len; ++Part) Ret -= Part->iov_len;
+		if (Part != End) {
+			Part->iov_base = static_cast <char *> (Part->iov_base) + Ret;
+			Part->iov_len -= Ret;
+		}
+	}
+	return true;
+}//WriteParts()
+
+/*!
+* \brief Write a file from several buffers, without copying them (writev)
+* \param[in] File File to write
+* \param[in] Parts The buffers, in order (modified by the partial writes)
+* \return False if the file can't be written (it is then left unchanged)
+*/
+bool WriteFileAtomic(const string & File, vector <struct iovec> & Parts) {
+	bool IsDone(false);
+	return WriteFileAtomic(File, [&](vector <struct iovec> & Next) {
+		if (IsDone) return false;
+		Next.swap(Parts);
+		return IsDone = true;
+	});
+}//WriteFileAtomic()
+
+/*!
+* \brief Write a file from buffers given batch by batch : the whole content never has to be in memory
+*
+* Le contenu est écrit dans un fichier temporaire voisin puis renommé : le fichier est remplacé en entier ou pas du tout.
+* Le fichier temporaire est synchronisé (fsync()) avant le renommage, puis le dossier après : après un crash, le nom ne peut
+* pas désigner un fichier dont les données ne sont pas encore sur le disque.
+* \param[in] File File to write
+* \param[in] NextParts Called until it returns false : fills its (emptied) argument with the next buffers, which must stay
+* valid until the next call
+* \return False if the file can't be written (it is then left unchanged)
+*/
+bool WriteFileAtomic(const string & File, const function <bool (vector <struct iovec> &)> & NextParts) {
+
+	const string TmpFile = File + ".tmp" + to_string(getpid());
+	const int Fd = open(TmpFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (Fd < 0) return false;
+
+	vector <struct iovec> Parts;
+	bool IsWritten(true);
+
+	while (IsWritten) {
+		Parts.clear();
+		if (!NextParts(Parts)) break;
+		IsWritten = WriteParts(Fd, Parts);
+	}
+
+	IsWritten = IsWritten && 0 == fsync(Fd);
+	IsWritten = (0 == close(Fd)) && IsWritten;
+	if (!IsWritten || 0 != rename(TmpFile.c_str(), File.c_str())) {
+		unlink(TmpFile.c_str());
+		return false;
+	}
+
+	/* Le renommage lui-même n'est durable qu'une fois le dossier synchronisé */
+	const size_t Slash = File.rfind('/');
+	const string Dir = (string::npos == Slash ? "." : 0 == Slash ? "/" : File.substr(0, Slash));
+	const int DirFd = open(Dir.c_str(), O_RDONLY | O_DIRECTORY);
+	if (DirFd >= 0) {
+		fsync(DirFd);
+		close(DirFd);
+	}
+	return true;
+}//WriteFileAtomic()
+
+ /*!
+ * \brief Initiate values to an empty matrix
+ * \param[in] Rules Rules of the game (case tokens)
+ * \param[in] NbLine The matrix size (axe Y)
+ * \param[in] NbColumn The matrix size (axe X)
+ * \param[in] PlayerX The first player that will be put on the matrice
+ * \param[in] PlayerY The second player that will be put on the matrice
+ * \param[in] ShowBorder Creating borders or not
+ * \return The completed matrix (InitMatrice <CChunkedMatrice>() : only the tiles of the players and of the border are allocated)
+ */
+
+template <typename TMatrice = CMatrice>
+TMatrice InitMatrice(const SRules & Rules, unsigned NbLine, unsigned NbColumn, SPlayer & PlayerX, SPlayer & PlayerY, bool ShowBorder = true) {
+	TMatrice Matrice(NbLine, NbColumn, Rules.m_caseEmpty);
+
+	Matrice.FillRect(PlayerX.m_Y, PlayerX.m_X, PlayerX.m_sizeY, PlayerX.m_sizeX, PlayerX.m_token);
+	Matrice.FillRect(PlayerY.m_Y, PlayerY.m_X, PlayerY.m_sizeY, PlayerY.m_sizeX, PlayerY.m_token);
+
+	if (ShowBorder && NbLine > 0 && NbColumn > 0) {
+		Matrice.FillRect(0, 0, 1, NbColumn, Rules.m_caseBorder);
+		Matrice.FillRect(NbLine - 1, 0, 1, NbColumn, Rules.m_caseBorder);
+		Matrice.FillRect(0, 0, NbLine, 1, Rules.m_caseBorder);
+		Matrice.FillRect(0, NbColumn - 1, NbLine, 1, Rules.m_caseBorder);
+	}
+
+
+	return Matrice;
+} //InitMatrice()
+
+/*!
+* \brief Get the escape sequence used to display a case
+* \param[in] Case The case token
+* \return The color escape sequence(s) of Case
+*/
+
+string CaseColor(const char Case) {
+
+	string Color;
+
+	/*GESTION DES CoulEURS*/
+	if (Case == CaseObstacle) Color += "\033[" + KBold + "m\033[" + KHNoir + "m";
+	if (Case == BonusX) Color += "\033[34m\033[" + KHVert + "m";
+	if (Case == BonusY) Color += "\033[34m\033[" + KHVert + "m";
+	if (Case == BonusZ) Color += "\033[34m\033[" + KHVert + "m";
+	if (Case == TokenPlayerX) Color += "\033[" + KBold + "m\033[34m\033[" + KHCyan + "m";
+	if (Case == TokenPlayerY) Color += "\033[" + KBold + "m\033[34m\033[" + KHJaune + "m";
+	if (Case == CaseEmpty) Color += "\033[" + KMagenta + "m";
+
+	return Color;
+}//CaseColor()
+
+/*!
+* \brief Get the console column where the matrix starts (centered)
+* \return The first column (starting at 1)
+*/
+
+unsigned BoardColumn() {
+	return (size.ws_col / 2 > 2 ? size.ws_col / 2 - 1 : 1);
+} //BoardColumn()
+
+  /*!
+  * \brief Show matrix on console (only the part that fits in the console, around a case)
+  * \param[in] Matrice The matrix to display
+  * \param[in] Clear Optional boolean that will clear or not the console
+  * \param[in] FocusX Column of the case kept in the middle of a matrix bigger than the console
+  * \param[in] FocusY Line of the case kept in the middle of a matrix bigger than the console
+  */
+
+template <typename TMatrice>
+void ShowMatrice(const TMatrice & Matrice, const bool Clear = true, const unsigned FocusX = 0, const unsigned FocusY = 0) {
+
+	if (Clear) ClearScreen();
+	PrintLines(2);
+	Couleur(KReset);
+
+	const unsigned NbRow = (0 != size.ws_row ? size.ws_row : 24), NbCol = (0 != size.ws_col ? size.ws_col : 80);
+	const unsigned Height = min(Matrice.NbLine(), NbRow > KInfoHeight ? NbRow - KInfoHeight : 1U), Width = min(Matrice.NbColumn(), NbCol);
+	const unsigned FirstLine = min(FocusY > Height / 2 ? FocusY - Height / 2 : 0, Matrice.NbLine() - Height);
+	const unsigned FirstColumn = min(FocusX > Width / 2 ? FocusX - Width / 2 : 0, Matrice.NbColumn() - Width);
+	const unsigned Margin = (Matrice.NbColumn() + BoardColumn() <= NbCol ? BoardColumn() - 1 : 0);
+
+	for (unsigned i(FirstLine); i < FirstLine + Height; ++i) {
+		cout << string(Margin, ' ');
+		for (unsigned a(FirstColumn); a < FirstColumn + Width; ++a) {
+
+			/* Deux cases voisines identiques partagent la même couleur */
+			if (FirstColumn == a || Matrice.Get(i, a) != Matrice.Get(i, a - 1)) {
+				if (FirstColumn != a) Couleur(KReset);
+				cout << CaseColor(Matrice.Get(i, a));
+			}
+			cout << Matrice.Get(i, a);
+		}
+		Couleur(KReset);
+
+		cout << endl;
+	}
+}//ShowMatrice
+
+/**
+* \class CBoardRenderer
+* \brief Affichage incrémental d'une fenêtre de la matrice.
+*
+* Seule une fenêtre de la taille de la console (SetView()) est affichée : elle suit le joueur actif et se recentre
+* quand il approche de son bord. En mode minimap, toute la matrice est réduite à la fenêtre, une case par bloc
+* (la case du centre du bloc, les joueurs par-dessus) : le coût d'un Draw() ne dépend que de la taille de la console.
+* Le renderer garde une copie de ce qui est actuellement affiché (front buffer) ; à chaque Draw(), la fenêtre
+* (back buffer) lui est comparée ligne par ligne et seules les cases modifiées sont réécrites (curseur + couleur + token).
+*/
+class CBoardRenderer {
+public:
+	CBoardRenderer() : m_Line(1), m_Column(1), m_IsValid(false), m_ViewHeight(24), m_ViewWidth(80),
+		m_ViewLine(0), m_ViewColumn(0), m_StepLine(1), m_StepColumn(1), m_IsMinimap(false), m_NbMark(0) {}
+
+	/*!
+	* \brief Force a full redraw on the next Draw() (console was cleared)
+	*/
+	void Invalidate() { m_IsValid = false; }
+
+	bool IsValid() const { return m_IsValid; }
+
+	/*!
+	* \brief Set where the matrix is displayed on the console
+	* \param[in] Line First line of the matrix (starting at 1)
+	* \param[in] Column First column of the matrix (starting at 1)
+	*/
+	void SetOrigin(const unsigned Line, const unsigned Column) {
+		if (Line != m_Line || Column != m_Column) m_IsValid = false;
+		m_Line = Line;
+		m_Column = Column;
+	}
+
+	/*!
+	* \brief Set the biggest window displayed (console cases)
+	* \param[in] Height Number of lines
+	* \param[in] Width Number of columns
+	*/
+	void SetView(const unsigned Height, const unsigned Width) {
+		m_ViewHeight = max(Height, 1U);
+		m_ViewWidth = max(Width, 1U);
+	}
+
+	/*!
+	* \brief Follow a player (the window stays around him) and mark both players on the minimap
+	* \param[in] Active The player followed
+	* \param[in] Other The other player
+	*/
+	void Follow(const SPlayer & Active, const SPlayer & Other) {
+		m_Marks[0] = { Active.m_X, Active.m_Y, Active.m_token };
+		m_Marks[1] = { Other.m_X, Other.m_Y, Other.m_token };
+		m_NbMark = 2;
+	}
+
+	void ToggleMinimap() { m_IsMinimap = !m_IsMinimap; }
+	bool IsMinimap() const { return m_IsMinimap; }
+
+	/*!
+	* \brief Check if the whole matrix is displayed, case by case
+	* \param[in] Matrice The matrix
+	* \return False if a part of the matrix is out of the window or reduced (minimap)
+	*/
+	bool IsWhole(const CMatrice & Matrice) const {
+		return !m_IsMinimap && Matrice.NbLine() <= m_ViewHeight && Matrice.NbColumn() <= m_ViewWidth;
+	}
+
+	/*!
+	* \brief Get the matrix cases shown by the window (after a Draw())
+	* \param[out] Line First line shown
+	* \param[out] Column First column shown
+	* \param[out] NbLine Number of lines shown
+	* \param[out] NbColumn Number of columns shown
+	*/
+	void GetShownCases(unsigned & Line, unsigned & Column, unsigned & NbLine, unsigned & NbColumn) const {
+		Line = m_ViewLine;
+		Column = m_ViewColumn;
+		NbLine = m_Back.NbLine() * m_StepLine;
+		NbColumn = m_Back.NbColumn() * m_StepColumn;
+	}
+
+	/*!
+	* \brief Get the first console line under the matrix
+	* \return Line number (starting at 1)
+	*/
+	unsigned BottomLine() const { return m_Line + m_Front.NbLine(); }
+
+	/*!
+	* \brief Display the cases of the window that changed since the last call
+	* \param[in] Matrice The matrix to display
+	* \return Number of bytes sent to the console
+	*/
+	size_t Draw(const CMatrice & Matrice) {
+
+		if (m_IsMinimap) Reduce(Matrice);
+		else Crop(Matrice);
+
+		const bool IsResized = m_Back.NbLine() != m_Front.NbLine() || m_Back.NbColumn() != m_Front.NbColumn();
+		const bool Full = !m_IsValid || IsResized;
+		m_Out.clear();
+
+		/* Fenêtre plus étroite (minimap) : la fin des anciennes lignes est effacée, les lignes du dessous le sont par ClearBelow() */
+		if (m_IsValid && IsResized)
+			for (unsigned i(0); i < m_Back.NbLine(); ++i) {
+				MoveCursor(m_Out, m_Line + i, m_Column + m_Back.NbColumn());
+				m_Out += "\033[K";
+			}
+
+		if (Full) {
+			m_Front = m_Back;
+			for (unsigned i(0); i < 256; ++i) m_Colors[i] = CaseColor(char(i));
+		}
+
+		for (unsigned i(0); i < m_Back.NbLine(); ++i) {
+			const char * Row = m_Back[i];
+			char * FrontRow = m_Front[i];
+
+			if (!Full && equal(Row, Row + m_Back.NbColumn(), FrontRow)) continue;
+
+			unsigned NextColumn(m_Back.NbColumn());	/* colonne où se trouve le curseur après la dernière case écrite */
+			bool IsColored(false);	/* une couleur est active depuis la dernière case écrite */
+
+			for (unsigned a(0); a < m_Back.NbColumn(); ++a) {
+				if (!Full && Row[a] == FrontRow[a]) continue;
+
+				if (a != NextColumn) {
+					if (IsColored) m_Out += "\033[0m";
+					IsColored = false;
+					MoveCursor(m_Out, m_Line + i, m_Column + a);
+				}
+
+				/* Deux cases voisines identiques partagent la même couleur */
+				if (!IsColored || Row[a] != Row[a - 1]) {
+					if (IsColored) m_Out += "\033[0m";
+					m_Out += m_Colors[(unsigned char)Row[a]];
+					IsColored = true;
+				}
+
+				m_Out += Row[a];
+
+				FrontRow[a] = Row[a];
+				NextColumn = a + 1;
+			}
+
+			if (IsColored) m_Out += "\033[0m";
+		}
+
+		cout.write(m_Out.data(), m_Out.size());
+		m_IsValid = true;
+		return m_Out.size();
+	}
+
+	/*!
+	* \brief Move the cursor under the matrix and erase everything below
+	*/
+	void ClearBelow() {
+		m_Out.clear();
+		MoveCursor(m_Out, BottomLine(), 1);
+		m_Out += "\033[J";
+		cout.write(m_Out.data(), m_Out.size());
+	}
+
+private:
+	/* Position et token d'un joueur, pour la fenêtre et la minimap */
+	struct SMark {
+		unsigned m_X;
+		unsigned m_Y;
+		char m_token;
+	};
+
+	static void MoveCursor(string & Out, const unsigned Line, const unsigned Column) {
+		Out += "\033[" + to_string(Line) + ';' + to_string(Column) + 'H';
+	}
+
+	/*!
+	* \brief Move a window on one axis so that a case stays away from its edges
+	* \param[in,out] First First case of the window
+	* \param[in] Size Window size
+	* \param[in] Total Matrix size on this axis
+	* \param[in] Case The case to keep visible (the followed player)
+	*/
+	static void Scroll(unsigned & First, const unsigned Size, const unsigned Total, const unsigned Case) {
+		const unsigned Margin = Size / 4;
+		if (Case < First + Margin || Case + Margin >= First + Size) First = (Case > Size / 2 ? Case - Size / 2 : 0);
+		First = min(First, Total - Size);
+	}
+
+	/*!
+	* \brief Copy the window around the followed player into the back buffer
+	*/
+	void Crop(const CMatrice & Matrice) {
+		const unsigned Height = min(m_ViewHeight, Matrice.NbLine()), Width = min(m_ViewWidth, Matrice.NbColumn());
+
+		m_StepLine = m_StepColumn = 1;
+		if (0 != m_NbMark) {
+			Scroll(m_ViewLine, Height, Matrice.NbLine(), m_Marks[0].m_Y);
+			Scroll(m_ViewColumn, Width, Matrice.NbColumn(), m_Marks[0].m_X);
+		}
+		m_ViewLine = min(m_ViewLine, Matrice.NbLine() - Height);
+		m_ViewColumn = min(m_ViewColumn, Matrice.NbColumn() - Width);
+
+		if (Height != m_Back.NbLine() || Width != m_Back.NbColumn()) m_Back.Resize(Height, Width, ' ');
+		for (unsigned i(0); i < Height; ++i)
+			copy(Matrice[m_ViewLine + i] + m_ViewColumn, Matrice[m_ViewLine + i] + m_ViewColumn + Width, m_Back[i]);
+	}
+
+	/*!
+	* \brief Reduce the whole matrix into the back buffer (one case per block, players drawn over)
+	*/
+	void Reduce(const CMatrice & Matrice) {
+		m_StepLine = (Matrice.NbLine() + m_ViewHeight - 1) / m_ViewHeight;
+		m_StepColumn = (Matrice.NbColumn() + m_ViewWidth - 1) / m_ViewWidth;
+		m_ViewLine = m_ViewColumn = 0;
+
+		const unsigned Height = (Matrice.NbLine() + m_StepLine - 1) / m_StepLine, Width = (Matrice.NbColumn() + m_StepColumn - 1) / m_StepColumn;
+		if (Height != m_Back.NbLine() || Width != m_Back.NbColumn()) m_Back.Resize(Height, Width, ' ');
+
+		for (unsigned i(0); i < Height; ++i) {
+			const char * Row = Matrice[min(i * m_StepLine + m_StepLine / 2, Matrice.NbLine() - 1)];
+			char * BackRow = m_Back[i];
+			for (unsigned a(0); a < Width; ++a) BackRow[a] = Row[min(a * m_StepColumn + m_StepColumn / 2, Matrice.NbColumn() - 1)];
+		}
+
+		for (unsigned i(m_NbMark); i-- > 0;) {
+			const SMark & Mark = m_Marks[i];
+			if (Mark.m_Y / m_StepLine < Height && Mark.m_X / m_StepColumn < Width) m_Back[Mark.m_Y / m_StepLine][Mark.m_X / m_StepColumn] = Mark.m_token;
+		}
+	}
+
+	unsigned m_Line;	/*!< first console line of the matrix */
+	unsigned m_Column;	/*!< first console column of the matrix */
+	bool m_IsValid;	/*!< false if the console no longer shows m_Front */
+	unsigned m_ViewHeight;	/*!< biggest window (console lines) */
+	unsigned m_ViewWidth;	/*!< biggest window (console columns) */
+	unsigned m_ViewLine;	/*!< first matrix line shown */
+	unsigned m_ViewColumn;	/*!< first matrix column shown */
+	unsigned m_StepLine;	/*!< matrix lines per console line (minimap) */
+	unsigned m_StepColumn;	/*!< matrix columns per console column (minimap) */
+	bool m_IsMinimap;	/*!< whole matrix reduced to the window */
+	SMark m_Marks[2];	/*!< followed player, then the other one */
+	unsigned m_NbMark;
+	CMatrice m_Back;	/*!< window to display */
+	CMatrice m_Front;	/*!< what is currently displayed */
+	string m_Colors[256];	/*!< escape sequence of each token */
+	string m_Out;	/*!< output buffer, reused between calls */
+}; //CBoardRenderer
+
+/*!
+* \brief Show title and the window of the matrix around the active player, redrawing only what changed since the last call
+* \param[in] Renderer The renderer holding what is displayed
+* \param[in] TitleFile Title displayed above the matrix
+* \param[in] Matrice The matrix to display
+* \param[in] Active The player followed by the window
+* \param[in] Other The other player (shown on the minimap)
+*/
+
+void ShowBoard(CBoardRenderer & Renderer, const string & TitleFile, const CMatrice & Matrice, const SPlayer & Active, const SPlayer & Other) {
+
+	const unsigned NbRow = (0 != size.ws_row ? size.ws_row : 24), NbCol = (0 != size.ws_col ? size.ws_col : 80);
+
+	if (!Renderer.IsValid()) {
+		const unsigned Line = ShowTitle(TitleFile) + 3; /* +3 : ligne courante + PrintLines(2) de ShowMatrice */
+
+		/* Une carte qui tient sous le titre est affichée en entier, sinon KInfoHeight lignes restent pour les infos.
+		Une carte plus large que la moitié droite de la console commence à gauche */
+		const unsigned Free = (NbRow > Line ? NbRow - Line : 1);
+		Renderer.SetView(Matrice.NbLine() <= Free ? Free : max(Free, KInfoHeight + 1) - KInfoHeight, NbCol);
+		Renderer.SetOrigin(Line, Matrice.NbColumn() + BoardColumn() <= NbCol ? BoardColumn() : 1);
+		Renderer.Invalidate();
+	}
+
+	Renderer.Follow(Active, Other);
+	Renderer.Draw(Matrice);
+	Renderer.ClearBelow();
+
+	if (Renderer.IsWhole(Matrice)) return;
+
+	unsigned Line, Column, NbLine, NbColumn;
+	Renderer.GetShownCases(Line, Column, NbLine, NbColumn);
+	Couleur(KCyan);
+	if (Renderer.IsMinimap()) cout << "\r[+] Minimap de la carte " << Matrice.NbColumn() << 'x' << Matrice.NbLine()
+		<< " (touche " << KKeyMinimap << " : retour au plateau)";
+	else cout << "\r[+] Cases " << Column << '-' << Column + NbColumn - 1 << " x " << Line << '-' << Line + NbLine - 1
+		<< " sur " << Matrice.NbColumn() << 'x' << Matrice.NbLine() << " (touche " << KKeyMinimap << " : minimap)";
+	cout << "\n\r";
+	Couleur(KReset);
+}//ShowBoard()
+
+ /*!
+ * \brief Build a matrix from the text of a map (one line per matrix line)
+ * \param[in] Data The map text
+ * \param[in] Size The map text size
+ * \param[out] Map The loaded matrix
+ * \return False if the map is empty or if its lines don't have the same length
+ */
+
+template <typename TMatrice>
+bool ParseMap(const char * Data, size_t Size, TMatrice & Map) {
+
+	/* Un seul '\n' final n'ajoute pas de ligne (fichiers édités à la main) */
+	if (Size > 0 && '\n' == Data[Size - 1]) --Size;
+	if (0 == Size) {
+		SLog += "\n\r[!] La carte est vide !";
+		return false;
+	}
+
+	const char * const End = Data + Size;
+	const char * LineEnd = static_cast<const char *>(memchr(Data, '\n', Size));
+	if (nullptr == LineEnd) LineEnd = End;
+
+	unsigned NbColumn = LineEnd - Data;
+	if (NbColumn > 0 && '\r' == Data[NbColumn - 1]) --NbColumn;
+	const unsigned NbLine = count(Data, End, '\n') + 1;
+
+	/* Toutes les lignes ont la longueur de la première : le texte doit au moins les contenir */
+	if (uint64_t(NbLine) * NbColumn > Size) {
+		SLog += "\n\r[!] Carte invalide : " + to_string(NbLine) + " lignes de " + to_string(NbColumn) + " cases annoncées pour " + to_string(Size) + " octets.";
+		return false;
+	}
+
+	Map.Resize(NbLine, NbColumn, CaseEmpty);
+
+	const char * Line = Data;
+	for (unsigned i(0); i < NbLine; ++i) {
+		LineEnd = static_cast<const char *>(memchr(Line, '\n', End - Line));
+		if (nullptr == LineEnd) LineEnd = End;
+
+		unsigned Length = LineEnd - Line;
+		if (Length > 0 && '\r' == Line[Length - 1]) --Length;
+
+		if (Length != NbColumn) {
+			SLog += "\n\r[!] Carte invalide : la ligne " + to_string(i + 1) + " fait " + to_string(Length)
+				+ " cases au lieu de " + to_string(NbColumn) + '.';
+			Map = TMatrice();
+			return false;
+		}
+
+		Map.SetRow(i, 0, Line, Length);
+		Line = LineEnd + 1;
+	}
+
+	return true;
+}//ParseMap()
+
+/*
+FORMAT BINAIRE (.cmap), entiers en little endian :
+	"CMIF"	signature (4 octets)
+	u8		version (KBinaryMapVersion)
+	u32		nombre de lignes
+	u32		nombre de colonnes
+	u8		nombre de tokens N (1 à 255), suivi des N tokens
+	lignes	pour chaque ligne : suite de (u8 indice du token, varint longueur) couvrant exactement la ligne
+*/
+
+const string KBinaryMapMagic("CMIF");	/*!< binary map signature */
+const unsigned char KBinaryMapVersion(1);	/*!< binary map version */
+
+/*!
+* \brief Check if a map text is in binary format
+* \param[in] Data The map content
+* \param[in] Size The map content size
+* \return True if Data starts with the binary signature
+*/
+
+bool IsBinaryMap(const char * Data, const size_t Size) {
+	return Size >= KBinaryMapMagic.size() && 0 == memcmp(Data, KBinaryMapMagic.data(), KBinaryMapMagic.size());
+}//IsBinaryMap()
+
+/*!
+* \brief Append an unsigned to a binary buffer (little endian)
+* \param[out] Out The buffer
+* \param[in] Value The value to append
+*/
+
+void PutU32(string & Out, const uint32_t Value) {
+	for (unsigned i(0); i < 4; ++i) Out += char((Value >> (8 * i)) & 0xFF);
+}//PutU32()
+
+/*!
+* \brief Append a variable-length unsigned (LEB128) to a binary buffer
+* \param[out] Out The buffer
+* \param[in] Value The value to append
+*/
+
+void PutVarint(string & Out, uint64_t Value) {
+	while (Value >= 0x80) {
+		Out += char((Value & 0x7F) | 0x80);
+		Value >>= 7;
+	}
+	Out += char(Value);
+}//PutVarint()
+
+/*!
+* \brief Read a little endian unsigned
+* \param[in,out] Data Read position, moved after the value
+* \param[in] End End of the buffer
+* \param[out] Value The value read
+* \return False if the buffer is too short
+*/
+
+bool GetU32(const unsigned char * & Data, const unsigned char * End, uint32_t & Value) {
+	if (End - Data < 4) return false;
+	Value = uint32_t(Data[0]) | (uint32_t(Data[1]) << 8) | (uint32_t(Data[2]) << 16) | (uint32_t(Data[3]) << 24);
+	Data += 4;
+	return true;
+}//GetU32()
+
+/*!
+* \brief Read a variable-length unsigned (LEB128)
+* \param[in,out] Data Read position, moved after the value
+* \param[in] End End of the buffer
+* \param[out] Value The value read
+* \return False if the buffer is too short or the value too long
+*/
+
+bool GetVarint(const unsigned char * & Data, const unsigned char * End, uint64_t & Value) {
+	Value = 0;
+	for (unsigned Shift(0); Data < End && Shift < 64; Shift += 7) {
+		const unsigned char Byte = *Data++;
+		Value |= uint64_t(Byte & 0x7F) << Shift;
+		if (!(Byte & 0x80)) return true;
+	}
+	return false;
+}//GetVarint()
+
+/*!
+* \brief Encode a matrix in binary format (run-length encoded lines)
+* \param[in] Matrice The matrix to encode
+* \return The binary map
+*/
+
+string EncodeMapBinary(const CMatrice & Matrice) {
+
+	unsigned char TokenIndex[256];
+	string Tokens;
+
+	fill(TokenIndex, TokenIndex + 256, 0);
+	for (size_t i(0); i < Matrice.NbCase() && Tokens.size() < 256; ++i) {
+		const unsigned char Case = Matrice.Data()[i];
+		if (0 != TokenIndex[Case]) continue;
+		Tokens += char(Case);
+		TokenIndex[Case] = Tokens.size();	/* indice + 1, 0 = token absent */
+	}
+
+	string Out(KBinaryMapMagic);
+	Out += char(KBinaryMapVersion);
+	PutU32(Out, Matrice.NbLine());
+	PutU32(Out, Matrice.NbColumn());
+	Out += char(Tokens.size() == 256 ? 0 : Tokens.size());	/* 0 : les 256 tokens */
+	Out += Tokens;
+
+	for (unsigned i(0); i < Matrice.NbLine(); ++i) {
+		const char * Row = Matrice[i];
+
+		for (unsigned a(0); a < Matrice.NbColumn();) {
+			unsigned Run(1);
+			while (a + Run < Matrice.NbColumn() && Row[a + Run] == Row[a]) ++Run;
+
+			Out += char(TokenIndex[(unsigned char)Row[a]] - 1);
+			PutVarint(Out, Run);
+			a += Run;
+		}
+	}
+
+	return Out;
+}//EncodeMapBinary()
+
+/*!
+* \brief Decode a binary map
+* \param[in] Data The binary map
+* \param[in] Size The binary map size
+* \param[out] Map The decoded matrix
+* \return False if the binary map is invalid
+*/
+
+template <typename TMatrice>
+bool DecodeMapBinary(const char * Data, const size_t Size, TMatrice & Map) {
+
+	const unsigned char * Pos = reinterpret_cast<const unsigned char *>(Data) + KBinaryMapMagic.size();
+	const unsigned char * const End = reinterpret_cast<const unsigned char *>(Data) + Size;
+	uint32_t NbLine, NbColumn;
+
+	if (!IsBinaryMap(Data, Size) || Pos >= End || *Pos++ != KBinaryMapVersion
+		|| !GetU32(Pos, End, NbLine) || !GetU32(Pos, End, NbColumn) || Pos >= End) {
+		SLog += "\n\r[!] Carte binaire invalide : en-tête incorrect.";
+		return false;
+	}
+
+	const unsigned NbToken = (0 == *Pos ? 256 : *Pos);
+	++Pos;
+	if (End - Pos < NbToken) {
+		SLog += "\n\r[!] Carte binaire invalide : table des tokens tronquée.";
+		return false;
+	}
+
+	const unsigned char * const Tokens = Pos;
+	Pos += NbToken;
+
+	/* Chaque ligne coûte au moins 2 octets (token + longueur) : l'en-tête ne peut pas annoncer plus que ce qui reste.
+	   Une carte a au moins une case : sans colonne, des milliards de lignes vides ne coûteraient aucun octet.
+	   Une matrice creuse n'est pas limitée en surface, seulement en cases posées (plus bas) */
+	if (0 == NbLine || 0 == NbColumn || (!TMatrice::KIsSparse && uint64_t(NbLine) * NbColumn > KMaxMapCase)
+		|| uint64_t(End - Pos) < uint64_t(NbLine) * 2) {
+		SLog += "\n\r[!] Carte binaire invalide : taille " + to_string(NbColumn) + 'x' + to_string(NbLine) + " impossible.";
+		return false;
+	}
+
+	Map.Resize(NbLine, NbColumn, CaseEmpty);
+	uint64_t NbPlaced(0);	/* cases qui ne sont pas vides */
+
+	for (unsigned i(0); i < NbLine; ++i) {
+		uint64_t a(0), Run;
+
+		for (; a < NbColumn && Pos < End; a += Run) {
+			const unsigned Token = *Pos++;
+
+			if (Token >= NbToken || !GetVarint(Pos, End, Run) || 0 == Run || Run > NbColumn - a) break;
+			if (CaseEmpty != char(Tokens[Token]) && (NbPlaced += Run) > KMaxMapCase) break;
+			Map.FillRect(i, unsigned(a), 1, unsigned(Run), Tokens[Token]);
+		}
+
+		if (a != NbColumn) {
+			SLog += "\n\r[!] Carte binaire invalide : ligne " + to_string(i + 1) + " corrompue.";
+			Map = TMatrice();
+			return false;
+		}
+	}
+
+	return true;
+}//DecodeMapBinary()
+
+/*!
+* \brief Build a matrix from a map content, text or binary
+* \param[in] Content The map content
+* \param[out] Map The loaded matrix
+* \return False if the map is invalid
+*/
+
+template <typename TMatrice>
+bool ParseAnyMap(const string & Content, TMatrice & Map) {
+	if (IsBinaryMap(Content.data(), Content.size())) return DecodeMapBinary(Content.data(), Content.size(), Map);
+	return ParseMap(Content.data(), Content.size(), Map);
+}//ParseAnyMap()
+
+ /*!
+ * \brief Load map by file
+ *
+ * ./map/MyMap_<MapName>.cmap (binaire) est chargée si elle existe, sinon ./map/MyMap_<MapName>.map (texte).
+ * \param[in] MapName The map to load
+ * \return Loaded matrix (empty if the map can't be loaded ; LoadMapByFile <CChunkedMatrice>() : only the tiles holding something are allocated)
+ */
+
+template <typename TMatrice = CMatrice>
+TMatrice LoadMapByFile(const string & MapName) {
+
+	const string FullName = "./map/MyMap_" + MapName + ".map";
+	TMatrice LoadedMatrice;
+	string Content;
+
+	if (!ReadFile("./map/MyMap_" + MapName + ".cmap", Content) && !ReadFile(FullName, Content)) {
+		SLog += "\n\r[!] Impossible de lire la carte " + FullName;
+		return LoadedMatrice;
+	}
+
+	ParseAnyMap(Content, LoadedMatrice);
+	return LoadedMatrice;
+}//LoadMapByFile()
+
+/**
+* \class CCaseClassifier
+* \brief Classement de 64 cases à la fois : obstacles, bonus et tokens inconnus, un bit par case.
+*
+* Les tokens des règles sont chargés une fois dans des registres vectoriels. Compilé avec AVX2 (-mavx2) :
+* 2 x 32 cases par comparaison ; avec SSE2 (tout x86-64) : 4 x 16 cases ; sinon case par case.
+*/
+class CCaseClassifier {
+public:
+	explicit CCaseClassifier(const SRules & Rules) : m_Rules(Rules) {
+#if defined(__AVX2__)
+		m_Obstacle = _mm256_set1_epi8(Rules.m_caseObstacle);
+		m_BonusX = _mm256_set1_epi8(Rules.m_bonusX);
+		m_BonusY = _mm256_set1_epi8(Rules.m_bonusY);
+		m_BonusZ = _mm256_set1_epi8(Rules.m_bonusZ);
+		m_Empty = _mm256_set1_epi8(Rules.m_caseEmpty);
+		m_Border = _mm256_set1_epi8(Rules.m_caseBorder);
+		m_PlayerX = _mm256_set1_epi8(Rules.m_tokenPlayerX);
+		m_PlayerY = _mm256_set1_epi8(Rules.m_tokenPlayerY);
+#elif defined(__SSE2__)
+		m_Obstacle = _mm_set1_epi8(Rules.m_caseObstacle);
+		m_BonusX = _mm_set1_epi8(Rules.m_bonusX);
+		m_BonusY = _mm_set1_epi8(Rules.m_bonusY);
+		m_BonusZ = _mm_set1_epi8(Rules.m_bonusZ);
+		m_Empty = _mm_set1_epi8(Rules.m_caseEmpty);
+		m_Border = _mm_set1_epi8(Rules.m_caseBorder);
+		m_PlayerX = _mm_set1_epi8(Rules.m_tokenPlayerX);
+		m_PlayerY = _mm_set1_epi8(Rules.m_tokenPlayerY);
+#endif
+	}
+
+	/*!
+	* \brief Classify 64 cases
+	* \param[in] Cases The 64 cases
+	* \param[out] Obstacles Obstacle bits
+	* \param[out] Bonus Bonus bits
+	* \return Unknown token bits
+	*/
+	uint64_t Classify(const char * Cases, uint64_t & Obstacles, uint64_t & Bonus) const {
+		uint64_t Known(0);
+		Obstacles = 0;
+		Bonus = 0;
+
+#if defined(__AVX2__)
+		for (unsigned i(0); i < 64; i += 32) {
+			const __m256i Chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Cases + i));
+			const __m256i IsObstacle = _mm256_cmpeq_epi8(Chunk, m_Obstacle);
+			const __m256i IsBonus = _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, m_BonusX), _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, m_BonusY), _mm256_cmpeq_epi8(Chunk, m_BonusZ)));
+			const __m256i IsOther = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(Chunk, m_Empty), _mm256_cmpeq_epi8(Chunk, m_Border)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(Chunk, m_PlayerX), _mm256_cmpeq_epi8(Chunk, m_PlayerY)));
+
+			Obstacles |= uint64_t(uint32_t(_mm256_movemask_epi8(IsObstacle))) << i;
+			Bonus |= uint64_t(uint32_t(_mm256_movemask_epi8(IsBonus))) << i;
+			Known |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_or_si256(IsOther, _mm256_or_si256(IsObstacle, IsBonus))))) << i;
+		}
+#elif defined(__SSE2__)
+		for (unsigned i(0); i < 64; i += 16) {
+			const __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Cases + i));
+			const __m128i IsObstacle = _mm_cmpeq_epi8(Chunk, m_Obstacle);
+			const __m128i IsBonus = _mm_or_si128(_mm_cmpeq_epi8(Chunk, m_BonusX), _mm_or_si128(_mm_cmpeq_epi8(Chunk, m_BonusY), _mm_cmpeq_epi8(Chunk, m_BonusZ)));
+			const __m128i IsOther = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chunk, m_Empty), _mm_cmpeq_epi8(Chunk, m_Border)),
+				_mm_or_si128(_mm_cmpeq_epi8(Chunk, m_PlayerX), _mm_cmpeq_epi8(Chunk, m_PlayerY)));
+
+			Obstacles |= uint64_t(_mm_movemask_epi8(IsObstacle)) << i;
+			Bonus |= uint64_t(_mm_movemask_epi8(IsBonus)) << i;
+			Known |= uint64_t(_mm_movemask_epi8(_mm_or_si128(IsOther, _mm_or_si128(IsObstacle, IsBonus)))) << i;
+		}
+#else
+		for (unsigned i(0); i < 64; ++i) {
+			const char Case = Cases[i];
+			const uint64_t Bit = uint64_t(1) << i;
+
+			if (Case == m_Rules.m_caseObstacle) Obstacles |= Bit;
+			if (Case == m_Rules.m_bonusX || Case == m_Rules.m_bonusY || Case == m_Rules.m_bonusZ) Bonus |= Bit;
+			if ((Obstacles | Bonus) & Bit || Case == m_Rules.m_caseEmpty || Case == m_Rules.m_caseBorder
+				|| Case == m_Rules.m_tokenPlayerX || Case == m_Rules.m_tokenPlayerY) Known |= Bit;
+		}
+#endif
+
+		return ~Known;
+	}
+
+	/*!
+	* \brief Get the token of an empty case (to complete the end of a line)
+	* \return The empty case token
+	*/
+	char Empty() const { return m_Rules.m_caseEmpty; }
+
+private:
+	SRules m_Rules;
+#if defined(__AVX2__)
+	__m256i m_Obstacle, m_BonusX, m_BonusY, m_BonusZ, m_Empty, m_Border, m_PlayerX, m_PlayerY;
+#elif defined(__SSE2__)
+	__m128i m_Obstacle, m_BonusX, m_BonusY, m_BonusZ, m_Empty, m_Border, m_PlayerX, m_PlayerY;
+#endif
+}; //CCaseClassifier
+
+/**
+* \struct SMapScan
+* \brief Résultat de l'analyse d'une carte par ScanMap().
+*
+* Nombre d'obstacles, de bonus et de cases inconnues (token ne correspondant à aucune règle),
+* et position de la première case inconnue (m_unknownX, m_unknownY).
+*/
+typedef struct {
+	size_t m_nbObstacle;
+	size_t m_nbBonus;
+	size_t m_nbUnknown;
+	unsigned m_unknownX;
+	unsigned m_unknownY;
+} SMapScan;
+
+/*!
+* \brief Analyse a whole map in a single pass, 64 cases at a time (CCaseClassifier)
+*
+* Les bits trouvés sont écrits directement dans les calques : un mot de 64 cases par appel.
+* \param[in] Rules Rules of the game (tokens)
+* \param[in] Map The map
+* \param[out] Obstacles If not null, obstacle layer (already sized to the map)
+* \param[out] Bonus If not null, bonus layer (already sized to the map)
+* \return Number of obstacles, bonus and unknown cases
+*/
+
+SMapScan ScanMap(const SRules & Rules, const CMatrice & Map, CBitBoard * Obstacles = nullptr, CBitBoard * Bonus = nullptr) {
+
+	const CCaseClassifier Classifier(Rules);
+	SMapScan Scan = { 0, 0, 0, 0, 0 };
+	char Tail[64];
+	uint64_t ObstacleBits, BonusBits;
+
+	for (unsigned i(0); i < Map.NbLine(); ++i) {
+		const char * Row = Map[i];
+
+		for (unsigned Word(0); Word * 64 < Map.NbColumn(); ++Word) {
+			const unsigned Column = Word * 64;
+			const char * Cases = Row + Column;
+
+			/* Fin de ligne : les cases suivantes (ligne d'après) sont lues puis masquées ; en fin de carte, complétée par des cases vides */
+			if (Map.NbCase() - (size_t(i) * Map.NbColumn() + Column) < 64) {
+				fill(copy(Cases, Row + Map.NbColumn(), Tail), Tail + 64, Classifier.Empty());
+				Cases = Tail;
+			}
+
+			uint64_t Unknown = Classifier.Classify(Cases, ObstacleBits, BonusBits);
+			if (Map.NbColumn() - Column < 64) {
+				const uint64_t InRow = (uint64_t(1) << (Map.NbColumn() - Column)) - 1;
+				Unknown &= InRow;
+				ObstacleBits &= InRow;
+				BonusBits &= InRow;
+			}
+
+			if (0 != Unknown) {
+				if (0 == Scan.m_nbUnknown) {
+					Scan.m_unknownX = Column + unsigned(__builtin_ctzll(Unknown));
+					Scan.m_unknownY = i;
+				}
+				Scan.m_nbUnknown += __builtin_popcountll(Unknown);
+			}
+
+			if (0 != ObstacleBits) Scan.m_nbObstacle += __builtin_popcountll(ObstacleBits);
+			if (0 != BonusBits) Scan.m_nbBonus += __builtin_popcountll(BonusBits);
+
+			if (nullptr != Obstacles) Obstacles->SetWord(i, Word, ObstacleBits);
+			if (nullptr != Bonus) Bonus->SetWord(i, Word, BonusBits);
+		}
+	}
+
+	return Scan;
+}//ScanMap()
+
+// WIN CHECK - WIN STAT
+
+/*!
+* \brief Check if someone  won : the two players overlap
+* \param[in] Match The game
+* \return If PlayerX or PlayerY won
+*/
+
+bool CheckIfWin(const SMatch & Match) {
+	const SPlayer & PlayerX = Match.m_playerX;
+	const SPlayer & PlayerY = Match.m_playerY;
+
+	/* Seule la zone commune aux deux joueurs est comparée sur leurs calques */
+	const unsigned Line = max(PlayerX.m_Y, PlayerY.m_Y);
+	const unsigned Column = max(PlayerX.m_X, PlayerY.m_X);
+	const unsigned LastLine = min(PlayerX.m_Y + PlayerX.m_sizeY, PlayerY.m_Y + PlayerY.m_sizeY);
+	const unsigned LastColumn = min(PlayerX.m_X + PlayerX.m_sizeX, PlayerY.m_X + PlayerY.m_sizeX);
+	if (Line >= LastLine || Column >= LastColumn) return false;
+
+	return Match.m_playerLayerX.Intersects(Match.m_playerLayerY, Line, Column, LastLine - Line, LastColumn - Column);
+} //CheckIfWin()
+
+/*!
+* \brief Get the game winner
+* \param[in] PlayerX The first player
+* \param[in] PlayerY The second player
+* \param[in] NbrTour The final round number
+* \return The game winner
+*/
+
+SPlayer GetWinner(const SPlayer& PlayerX, const SPlayer &PlayerY, const unsigned & NbrTour) {
+	return (NbrTour % 2 == 0 ? PlayerX : PlayerY);
+} //GetWinner()
+
+/*!
+* \brief Display win screen
+* \param[in] The final round number
+* \param[in] IsBot (Optional) Is the game agains't IA
+*/
+
+void DisplayWin(const unsigned &Tour, const bool &IsBot = true) {
+
+	SPlayer Winner = GetWinner(PlayerX, PlayerY, Tour);
+
+	if (IsBot)
+		ClearScreen();
+
+
+	PrintLines(1);
+	Couleur(KRouge, KHCyan);
+
+	PrintLines(6);
+	cout << endl << endl << "[!] Le joueur '" << Winner.m_token << "' a gagné avec : ";
+
+	Couleur(KHBleu, KHGris); cout << Winner.m_score;
+	Couleur(KRouge, KHCyan); cout << " points" << '!' << endl << '\r';
+
+	if (BShowHistory) {
+		PrintLines(3);
+		Couleur(KRouge, KHJaune);
+
+		cout << "Historique du gagnant : \n\r" << endl << "n° | Mouv \n\r" << "________\n\r";
+
+		for (unsigned i(0); i < Winner.m_history.size(); ++i)
+			cout << "| " << i << " | " << Winner.m_history[i] << " | " << "\n\r";
+
+	}
+
+	Couleur(KReset);
+	endwin();
+	return;
+} //DisplayWin()
+
+// BONUS
+
+/*!
+* \brief Initiate values to an empty bonus
+* \param[in] AxeX Position X of bonus
+* \param[in] AxeY Position Y of bonus
+* \param[in] Token Bonus token
+* \return Final bonus
+*/
+
+SBonus InitBonus(const unsigned AxeX, const unsigned AxeY, const char Token) {
+
+	SBonus Bonus;
+
+	Bonus.m_X = AxeX;
+	Bonus.m_Y = AxeY;
+	Bonus.m_token = Token;
+
+	return Bonus;
+}//InitBonus()
+ /*!
+ * \brief Put bonus to matrix
+ * \param[in] Match The game (map size, bonus layer)
+ * \param[in] Matrice Matrix where the bonus will be put on
+ * \param[in] Bonus Bonus to put
+ */
+
+template <typename TMatrice>
+void PutBonus(SMatch & Match, TMatrice & Matrice, SBonus & Bonus) {
+	const SRules & Rules = Match.m_rules;
+
+	if ((Bonus.m_Y > 1 && Bonus.m_X > 1) && (Bonus.m_Y < Rules.m_sizeY - 1 && Bonus.m_X < Rules.m_sizeX - 1)) {
+		Matrice.Set(Bonus.m_Y, Bonus.m_X, Bonus.m_token);
+		Match.m_bonusLayer.Insert(Bonus.m_X, Bonus.m_Y);
+	}
+}//PutBonus()
+
+ /*!
+ * \brief Bonus X : the player grows by one line and one column
+ * \param[in] Match The game
+ * \param[in] Matrice The game map
+ * \param[in] Player The player who took the bonus
+ */
+
+template <typename TMatrice>
+void ApplyBonusGrow(SMatch & Match, TMatrice & Matrice, SPlayer & Player) {
 
+	if (Player.m_X == 1) Match.m_log += "\n\rVous avez déjà prit un bonus de ce type !";
+	++Player.m_sizeX;
+	++Player.m_sizeY;
+	Match.m_log += "\n\rVotre taille a augmenté!. \n\rVous pouvez désormé traverser les obstacles";
+	Player.m_score += 25;
+	Match.m_log += "\n\r\n\rCe bonus vous a fait gagner 25 points!";
 
-/*COULEURS BASIQUE*/
+	/* Seules la nouvelle ligne (en bas) et la nouvelle colonne (à droite) sont à marquer : les bonus recouverts sont perdus */
+	FillPlayerRect(Match, Matrice, Player, Player.m_Y + Player.m_sizeY - 1, Player.m_X, 1, Player.m_sizeX, true);
+	FillPlayerRect(Match, Matrice, Player, Player.m_Y, Player.m_X + Player.m_sizeX - 1, Player.m_sizeY - 1, 1, true);
+	Match.m_bonusLayer.FillRect(Player.m_Y + Player.m_sizeY - 1, Player.m_X, 1, Player.m_sizeX, false);
+	Match.m_bonusLayer.FillRect(Player.m_Y, Player.m_X + Player.m_sizeX - 1, Player.m_sizeY - 1, 1, false);
+}//ApplyBonusGrow()
 
-// !alias to the reset color display
-const string KReset("0");
-// !alias to the black color 
-const string KNoir("30");
-// !alias to the red color 
-const string KRouge("31");
-// !alias to the green color 
-const string KVert("32");
-// !alias to the yellow color 
-const string KJaune("33");
-// !alias to the blue color 
-const string KBleu("34");
-// !alias to the magenta color 
-const string KMagenta("35");
-// !alias to the cyan color 
-const string KCyan("36");
-// !alias to the black color 
-const string KUnderLine("4");
-// !alias to underline some text 
-const string KBold("1");
-// !alias to bold some text
-const string KOverLine("53");
-// !alias to overline some text
+ /*!
+ * \brief Bonus Y : points only
+ * \param[in] Match The game
+ * \param[in] Matrice The game map
+ * \param[in] Player The player who took the bonus
+ */
 
-/*HIGHTLIGHT*/
-const string KHNoir("40");
-// !alias to the black highlight 
-const string KHRouge("41");
-// !alias to the red highlight
-const string KHVert("42");
-// !alias to the green highlight
-const string KHJaune("43");
-// !alias to the yellow highlight
-const string KHBleu("44");
-// !alias to the blue highlight
-const string KHMagenta("45");
-// !alias to the magenta highlight
-const string KHCyan("46");
-// !alias to the cyan highlight
-const string KHGris("47");
-// !alias to the grey highlight
+template <typename TMatrice>
+void ApplyBonusPoints(SMatch & Match, TMatrice & /*Matrice*/, SPlayer & Player) {
 
-/* VARIABLES DE CONFIGURATION */
+	Player.m_score += 15;
+	Match.m_log += "\n\r\n\rCe bonus ne fait strictement rien\n\rExcepté vous faire gagner 15 points!";
+}//ApplyBonusPoints()
 
-// !alias to the console size
-struct winsize size;
+ /*!
+ * \brief Bonus Z : random obstacles are put on the map
+ * \param[in] Match The game
+ * \param[in] Matrice The game map
+ * \param[in] Player The player who took the bonus
+ */
 
-vector <SObstacle> VObstacle;	/*!< all referenced obstacles */
-vector <string> VOptionsName;	/*!<  options names */
-vector <string> VOptionValue;	/*!< options values */
-string SLog;  /*!< log string */
+template <typename TMatrice>
+void ApplyBonusObstacles(SMatch & Match, TMatrice & Matrice, SPlayer & Player) {
+
+	Match.m_log += "\n\rDes obstacles aléatoires ont été placés!";
+	Player.m_score += 10;
+	Match.m_log += "\n\r\n\rCe bonus vous a fait gagner 10 points!";
+	GenerateStaticObject(Match, Matrice, Match.m_rules.m_difficult, 2, 1);
+
+	/* Les nouveaux obstacles et bonus ne doivent pas recouvrir le joueur */
+	FillPlayerRect(Match, Matrice, Player, Player.m_Y, Player.m_X, Player.m_sizeY, Player.m_sizeX, true);
+	Match.m_bonusLayer.FillRect(Player.m_Y, Player.m_X, Player.m_sizeY, Player.m_sizeX, false);
+}//ApplyBonusObstacles()
+
+/*! Effect of a bonus on the player who takes it */
+template <typename TMatrice>
+using FBonusEffect = void (*)(SMatch & Match, TMatrice & Matrice, SPlayer & Player);
+
+/*! Bonus token (member of SRules) and its effect */
+template <typename TMatrice>
+struct SBonusEffect {
+	char SRules::* m_token;
+	FBonusEffect <TMatrice> m_apply;
+};
+
+/*! Effects of the bonus, looked up by token (one table per kind of map) */
+template <typename TMatrice>
+struct CBonusEffects {
+	static const SBonusEffect <TMatrice> m_List[3];
+};
+
+template <typename TMatrice>
+const SBonusEffect <TMatrice> CBonusEffects <TMatrice>::m_List[3] = {
+	{ &SRules::m_bonusX, ApplyBonusGrow <TMatrice> },
+	{ &SRules::m_bonusY, ApplyBonusPoints <TMatrice> },
+	{ &SRules::m_bonusZ, ApplyBonusObstacles <TMatrice> },
+};
 
+ /*!
+ * \brief Mark the cases the player just entered and apply the bonus found there
+ *
+ * Seul le bord d'entrée (la ligne ou la colonne du côté du déplacement) est lu et marqué : un pas coûte la largeur du joueur.
+ * Le calque des bonus est testé mot par mot, les cases ne sont lues qu'en présence d'un bonus.
+ * \param[in] Match The game
+ * \param[in] Matrice The game map
+ * \param[in] Player The player, already moved
+ * \param[in] Move The movement just done
+ */
 
-bool BShowRules;	/*!< Showing rules or not */
-bool BShowHistory;	/*!< Showing history or not  */
+template <typename TMatrice>
+void GetBonus(SMatch & Match, TMatrice & Matrice, SPlayer & Player, const char Move) {
 
-unsigned KSizeY;	/*!< Matrix size (Y axe) */
-unsigned KSizeX;	/*!< Matrix size (X axe) */
-unsigned KDifficult;	/*!< Difficulty */
+	unsigned Line, Column, Height, Width;
+	if (!GetEnteredEdge(Match.m_rules, Player, Move, Line, Column, Height, Width)) return;
 
-char BonusY;	/*!< Bonus Y token */
-char BonusX;	/*!< Bonus X token */
-char BonusZ;	/*!< Bonus Z token */
-char CMouvLeft;	/*!< Key associed to left movement */
-char CMouvTop;	/*!< Key associed to top movement */
-char CMouvBot;	/*!< Key associed to bot movement */
-char CMouvRight;	/*!< Key associed to rigght movement */
-char CaseEmpty;	/*!< Empty case token */
-char CaseObstacle;	/*!< Obstacle case token */
-char CaseBorder;	/*!< Border case token */
-char TokenPlayerX;	/*!< First player token */
-char TokenPlayerY;	/*!< Second player token */
+	if (Match.m_bonusLayer.AnyInRect(Line, Column, Height, Width)) {
+		for (unsigned i(Line); i < Line + Height; ++i) {
+			for (unsigned j(Column); j < Column + Width; ++j) {
+				if (!Match.m_bonusLayer.Contains(j, i)) continue;
 
-SPlayer PlayerX;	/*!< First player */
-SPlayer PlayerY;	/*!< First player  */
+				const char Token = Matrice.Get(i, j);
+				Match.m_bonusLayer.Erase(j, i);
+				Matrice.Set(i, j, Player.m_token);
 
-void DisplayLog();
-void DisplayMenu();
-void DisplaySoloIA();
-void DisplayHistory();
-void DisplayEditor();
-void DisplayInfos(const SPlayer & Player);
-void GenerateStaticObject(CMatrice & Map, unsigned & Difficulty, const unsigned & NbObs, const unsigned & NbBonus);
+				for (const SBonusEffect <TMatrice> & Effect : CBonusEffects <TMatrice>::m_List) {
+					if (Token != Match.m_rules.*Effect.m_token) continue;
+					Effect.m_apply(Match, Matrice, Player);
+					break;
+				}
+			}
+		}
+	}
 
-//SCREEN - INITS
+	FillPlayerRect(Match, Matrice, Player, Line, Column, Height, Width, true);
+}//GetBonus()
+
+// OBSTACLES
 
 /*!
-* \brief Print color
-* \param[in] Coul Color wanted
-* \param[in] Hightlight Optional highlight wanted
+* \brief Check if player is surrounded of obstacles
+* \param[in] Rules Rules of the game (obstacle token)
+* \param[in] Matrice The game map
+* \param[in] Player The player to check
+* \return True if player is surrounded
 */
-void Couleur(const string & Coul, const string & Hightlight = "") {
+template <typename TMatrice>
+bool IsSurrounded(const SRules & Rules, const TMatrice & Map, SPlayer & Player) {
+	if (Player.m_Y + 1 >= Map.NbLine() || Player.m_X + 1 >= Map.NbColumn()) return true;
+	return (Map.Get(Player.m_Y + 1, Player.m_X + 1) == Rules.m_caseObstacle);
+}//IsSurrounded()
 
-	if (Hightlight != "")
-		cout << "\033[34m\033[" << Hightlight << "m";
-	else
-		cout << "\033[" << Coul << "m";
 
+/*!
+* \brief Initiate values to an empty obstacle
+* \param[in] AxeX Position X of obstacle
+* \param[in] AxeY Position Y of obstacle
+* \param[in] Token obstacle token
+* \return Final obstacle
+*/
+
+SObstacle InitObstacle(const unsigned
+	AxeX, const unsigned AxeY, const char Token) {
 
-} //Couleur()
+	SObstacle Obstacle;
+
+	Obstacle.m_X = AxeX;
+	Obstacle.m_Y = AxeY;
+	Obstacle.m_token = Token;
+	return Obstacle;
+} //InitObstacle()
 
 /*!
-* \brief Ask player maximum round
-* \return Return the maximum round
+* \brief Put obstacle to matrix
+* \param[in] Match The game
+* \param[in] Matrice Matrix where the obstacle will be put on
+* \param[in] Obstacle Obstacle to put
 */
-unsigned GetTourMax() {
-	unsigned Nbround;
-
-	Couleur(KCyan);
-	cout << endl << "[?] Entrez le nombre de rounds : ";
 
-	while (!(cin >> Nbround)) {
-		Couleur(KRouge);
-		cout << "\n\r[!] Le nombre de tour est incorrect. Veillez réessayer : \n\r";
-		cin.clear();
-		break;
+template <typename TMatrice>
+void PutObstacle(SMatch & Match, TMatrice & Matrice, SObstacle & Obstacle) {
 
-	}
-	Couleur(KReset);
+	if (Obstacle.m_Y >= Matrice.NbLine() || Obstacle.m_X >= Matrice.NbColumn()) return;
 
-	return Nbround;
-} //GetTourMax()
+	Matrice.Set(Obstacle.m_Y, Obstacle.m_X, Obstacle.m_token);
+	if (Match.m_obstacleLayer.Insert(Obstacle.m_X, Obstacle.m_Y))
+		Match.m_obstacles.push_back(Obstacle);
 
+} //PutObstacle()
 
 /*!
-* \brief Set text to the middle screen
+* \brief Forget every obstacle, empty the layers and size them : only the players are marked
+* \param[in] Match The game, players placed
+* \param[in] Width Number of columns of the map
+* \param[in] Height Number of lines of the map
 */
 
-void SetTextMiddle() {
-	cout << setw(round(size.ws_col / 2));
+void SizeLayers(SMatch & Match, const unsigned Width, const unsigned Height) {
 
-} //SetTextMiddle()
+	Match.m_obstacles.clear();
+	Match.m_obstacleLayer.Reset(Width, Height);
+	Match.m_bonusLayer.Reset(Width, Height);
+	Match.m_playerLayerX.Reset(Width, Height);
+	Match.m_playerLayerY.Reset(Width, Height);
 
- /*!
- * \brief Clear console
- */
+	Match.m_playerLayerX.FillRect(Match.m_playerX.m_Y, Match.m_playerX.m_X, Match.m_playerX.m_sizeY, Match.m_playerX.m_sizeX, true);
+	Match.m_playerLayerY.FillRect(Match.m_playerY.m_Y, Match.m_playerY.m_X, Match.m_playerY.m_sizeY, Match.m_playerY.m_sizeX, true);
+} //SizeLayers()
 
-void ClearScreen() {
-	cout << "\033[H\033[2J";
-}//ClearScreen()
- /*!
- * \brief Generate random number
- * \param[in] Min Minimum range
- * \param[in] Max Maximum range
- * \return Random number between Min and Max
- */
-int Rand(int Min, int Max) {
+/*!
+* \brief Forget every obstacle and size the layers to a map : the players and the bonus already on the map are marked
+* \param[in] Match The game, players placed
+* \param[in] Matrice The new game map
+* \param[in] IsObstacleScanned Mark the obstacles of the map too (the obstacle list is not filled)
+* \return The map analysis (ScanMap())
+*/
 
-	random_device Random;
-	mt19937 Rng(Random());
-	uniform_int_distribution<int> uni(Min, Max);
+SMapScan ResetLayers(SMatch & Match, const CMatrice & Matrice, const bool IsObstacleScanned = false) {
+	SizeLayers(Match, Matrice.NbColumn(), Matrice.NbLine());
+	return ScanMap(Match.m_rules, Matrice, IsObstacleScanned ? &Match.m_obstacleLayer : nullptr, &Match.m_bonusLayer);
+} //ResetLayers()
 
-	return uni(Rng);
-}//Rand()
+/*!
+* \brief Forget every obstacle and size the layers to a chunked map : only its allocated tiles are read
+*
+* Une ligne de tuile (64 cases alignées) est exactement un mot des calques : chaque ligne est classée puis écrite d'un coup.
+* \param[in] Match The game, players placed
+* \param[in] Matrice The new game map
+* \param[in] IsObstacleScanned Mark the obstacles of the map too (the obstacle list is not filled)
+* \return The map analysis (the unknown case reported is the first one line by line)
+*/
 
- /*!
- * \brief Listen to keyboard using no-canonical mode
- */
-void ListenKeyboard() {
-	raw();
-	keypad(stdscr, TRUE);
-	noecho();
-} //ListenKeyboard()
-  /*!
-  * \brief Initiate curses allowing (with ListenKeyboard() ) to detect key
-  */
-void InitCurses() {
+SMapScan ResetLayers(SMatch & Match, const CChunkedMatrice & Matrice, const bool IsObstacleScanned = false) {
+	const unsigned Width(Matrice.NbColumn()), Height(Matrice.NbLine());
+	const CCaseClassifier Classifier(Match.m_rules);
+	SMapScan Scan = { 0, 0, 0, 0, 0 };
+	uint64_t ObstacleBits, BonusBits;
+
+	SizeLayers(Match, Width, Height);
+
+	Matrice.ForEachTile([&](const unsigned Line, const unsigned Column, const char * Cases) {
+		const uint64_t InRow = (Width - Column < 64 ? (uint64_t(1) << (Width - Column)) - 1 : ~uint64_t(0));
+
+		for (unsigned i(Line); i < min(Height, Line + CChunkedMatrice::KTileSize); ++i, Cases += CChunkedMatrice::KTileSize) {
+			const uint64_t Unknown = Classifier.Classify(Cases, ObstacleBits, BonusBits) & InRow;
+			ObstacleBits &= InRow;
+			BonusBits &= InRow;
+
+			if (0 != Unknown) {
+				const unsigned X = Column + unsigned(__builtin_ctzll(Unknown));
+				if (0 == Scan.m_nbUnknown || i < Scan.m_unknownY || (i == Scan.m_unknownY && X < Scan.m_unknownX)) {
+					Scan.m_unknownX = X;
+					Scan.m_unknownY = i;
+				}
+				Scan.m_nbUnknown += __builtin_popcountll(Unknown);
+			}
 
-	initscr();
-	ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
-} //InitCurses()
+			Scan.m_nbObstacle += __builtin_popcountll(ObstacleBits);
+			Scan.m_nbBonus += __builtin_popcountll(BonusBits);
+			if (IsObstacleScanned) Match.m_obstacleLayer.SetWord(i, Column / 64, ObstacleBits);
+			Match.m_bonusLayer.SetWord(i, Column / 64, BonusBits);
+		}
+	});
 
-  /*!
-  * \brief PrintLines
-  * \param[in] LineNumber Number of line to display
-  */
-void PrintLines(const unsigned & LineNumber) {
-	for (unsigned i(0); i < LineNumber; ++i) cout << endl;
-} //PrintLines
-  /*!
-  * \brief Convert string to bool
-  * \param[in] Chaine String to convert
-  * \return True if Chaine equal to "true"
-  */
-bool StrToBool(const string & Chaine) {
-	return(Chaine == "true" ? true : false);
-} //StrToBool()
+	return Scan;
+} //ResetLayers()
 
 /*!
-* \brief Show title from file
-* \param[in] FileName File to read in
-* \param[in] Clear Clear or not the console (optional)
+* \brief Generate random obstacles into matrix
+* \param[in] Match The game
+* \param[in] Matrice Matrix where the obstacle will be put on
+* \param[in] Obstacle Obstacle to put
+* \param[in] Totalsize Number of obstacle to put
 */
-void ShowTitle(const string & FileName, const bool Clear = true) {
 
-	ClearScreen();
-	string StrTitle;
-	string StrDir = "asciititle";
-	ifstream IFSTitle(StrDir + '/' + FileName);
+template <typename TMatrice>
+void GenerateRandomObstacles(SMatch & Match, TMatrice & Matrice, const SObstacle & Obstacle, const unsigned & Totalsize) {
+	SObstacle NewObstacle = Obstacle;
 
-	PrintLines(1);
+	vector <unsigned> Randomvalues;
 
-	while (true) {
-		if (IFSTitle.eof()) break;
-		getline(IFSTitle, StrTitle);
-		cout << StrTitle << endl;
-	}
+	for (unsigned i(0); i < Totalsize; ++i) Randomvalues.push_back(Match.m_random.Range(1, 2));
 
-	IFSTitle.clear();
-}//ShowTitle()
+	for (unsigned i(0); i < Totalsize; ++i) {
 
-// OPTIONS
+		if (1 == Randomvalues[i]) {
+			++NewObstacle.m_Y;
+			PutObstacle(Match, Matrice, NewObstacle);
+		}
+		else if (2 == Randomvalues[i]) {
+			++NewObstacle.m_X;
+			PutObstacle(Match, Matrice, NewObstacle);
+		}
+	}
+} //GenerateRandomObstacles()
 
 /*!
-* \brief Initiate defaults options
+* \brief Check if player can move to the position he decided to go
+* \param[in] Match The game
+* \param[in] Player Player to check
+* \param[in] Movement The movement that the player will do
+* \return True if player can move to his future movement
 */
-void InitOptions() {
 
-	/*
-	All configs go here (InitOptions()) AND in header part (simple declaration) AND in SetConfig()
-	All DEFAULT values go here
-	*/
+bool IsMovementForbidden(SMatch & Match, SPlayer & Player, char & Movement) {
+	if (Player.m_sizeX != 1) return false;
 
-	KSizeX = 10;
-	KSizeY = 10;
-	KDifficult = 1;
-	BonusX = 'W';
-	BonusY = 'V';
-	BonusZ = 'U';
-	CMouvLeft = 'q';
-	CMouvTop = 'z';
-	CMouvBot = 's';
-	CMouvRight = 'd';
-	CaseEmpty = '.';
-	CaseObstacle = '#';
-	CaseBorder = '#';
-	TokenPlayerX = 'X';
-	TokenPlayerY = 'O';
-	BShowHistory = true;
-	BShowRules = true;
+	unsigned Line, Column, Height, Width;
+	if (!GetEnteredEdge(Match.m_rules, Player, Movement, Line, Column, Height, Width)) return false;
 
-	VOptionsName = { "CaseEmpty", "TokenPlayerX", "TokenPlayerY", "KSizeX", "KSizeY",  "KDifficult", "BShowRules", "BShowHistory" };
+	/* Le bord d'entrée, une fois le pas fait */
+	if (Movement == Match.m_rules.m_mouvTop) --Line;
+	else if (Movement == Match.m_rules.m_mouvBot) ++Line;
+	else if (Movement == Match.m_rules.m_mouvLeft) --Column;
+	else ++Column;
 
-	VOptionValue = { ".",  "X" ,"O", "10", "10", "1", "true", "true" };
+	if (!Match.m_obstacleLayer.AnyInRect(Line, Column, Height, Width)) return false;
 
-	if (1 == KDifficult) VOptionValue[5] = "1";
-	else VOptionValue[5] = "0";
+	Match.m_log += "\n\r\n\r Ce bonus vous a fait PERDRE 8 en score !";
+	Player.m_score -= 8;
 
-} //InitOptions()
+	return true;
+}//IsMovementForbidden()
 
-/*!
-* \brief Modify a specific config
-* \param[in] Name The configuration name
-* \param[in] Value The new value to affect
-*/
-void SetConfig(string Name, const string &Value) {
+ /*!
+ * \brief Generate random objects into map
+ * \param[in] Match The game
+ * \param[in] Map Map where objects will be put on
+ * \param[in] Difficulty The game difficulty
+ * \param[in] NbObs Number of obstacle to print
+ * \param[in] NbBonus Number of bonus to print
+ */
+
+template <typename TMatrice>
+void GenerateStaticObject(SMatch & Match, TMatrice & Map, unsigned & Difficulty, const unsigned & NbObs, const unsigned & NbBonus) {
 
-	vector<char> Valuetochar(Value.c_str(), Value.c_str() + Value.size() + 1u);
+	const SRules & Rules = Match.m_rules;
+	CRandom & Random = Match.m_random;
+	SObstacle TmpObs;
+	SBonus TmpBonus;
+	int RndBX, RndBY;
 
-	for (unsigned i(0); i < VOptionsName.size(); ++i)
-		if (VOptionsName[i] == Name) VOptionValue[i] = Value;
+	unsigned Choix;
 
+	if (1 == Difficulty) {/*EASY*/
 
-	if ("CMouvLeft" == Name) CMouvLeft = Valuetochar[0];
-	else if ("CMouvTop" == Name) CMouvTop = Valuetochar[0];
-	else if ("CMouvBot" == Name) CMouvBot = Valuetochar[0];
-	else if ("CMouvRight" == Name) CMouvRight = Valuetochar[0];
-	else if ("TokenPlayerX" == Name) TokenPlayerX = Valuetochar[0];
-	else if ("CaseEmpty" == Name) CaseEmpty = Valuetochar[0];
-	else if ("TokenPlayerY" == Name) TokenPlayerY = Valuetochar[0];
-	else if ("KSizeX" == Name) KSizeX = stoul(Value);
-	else if ("KSizeY" == Name) KSizeY = stoul(Value);
-	else if ("KDifficult" == Name) KDifficult = stoul(Value);
-	else if ("BShowRules" == Name) BShowRules = StrToBool(Value);
-	else if ("BShowHistory" == Name) BShowHistory = StrToBool(Value);
 
+		for (unsigned i(0); i < NbObs; ++i) {
 
-} //SetConfig();
+			int MaxX = round((Rules.m_sizeX / 2)) + Random.Range(1, 2);
+			int MaxY = round((Rules.m_sizeY / 2)) - Random.Range(0, 1);
 
-// MATRICE
+			int RndX = round(Random.Range(2, MaxX));
+			int RndY = round(Random.Range(2, MaxY));
 
-/*!
-* \brief Get the total of lines of a specific text file
-* \param[in] File File to read in
-* \return Total of "File" line
-*/
-unsigned GetMaxLine(const string & File) {
-	string Line;
-	unsigned NbLine(0);
-	ifstream ReadedMap(File);
+			TmpObs = InitObstacle(RndX, RndY, Rules.m_caseObstacle);
+
+			if ((Match.m_playerX.m_X == TmpObs.m_X && Match.m_playerX.m_Y == TmpObs.m_Y)
+				&& Match.m_playerY.m_X == TmpObs.m_X && Match.m_playerY.m_Y == TmpObs.m_Y) {
+
+				--i;
+				continue;
+			}
 
-	while (!ReadedMap.eof()) {
-		getline(ReadedMap, Line);
-		++NbLine;
+			else {
+				if (!(IsSurrounded(Rules, Map, Match.m_playerX)) || !(IsSurrounded(Rules, Map, Match.m_playerY)))
+					GenerateRandomObstacles(Match, Map, TmpObs, Random.Range(1, 3));
+			}
+		}
+
+		for (unsigned i(0); i < NbBonus; ++i) {
+			Choix = Random.Range(1, 3);
+			RndBX = Random.Range(round(Rules.m_sizeX - round(Rules.m_sizeX / 3)) - Random.Range(1, 3), round(Rules.m_sizeX - round(Rules.m_sizeX / 5)) + Random.Range(1, 3));
+			RndBY = Random.Range(round(Rules.m_sizeY - round(Rules.m_sizeY / 3)) - Random.Range(1, 3), round(Rules.m_sizeY - round(Rules.m_sizeY / 5)) + Random.Range(1, 3));
+
+			if (Choix == 1) TmpBonus = InitBonus(RndBX - 1, RndBY, Rules.m_bonusY);
+			else if (Choix == 2) TmpBonus = InitBonus(RndBX - 1, RndBY, Rules.m_bonusX);
+			else if (Choix == 3) TmpBonus = InitBonus(RndBX - 1, RndBY, Rules.m_bonusZ);
+
+			PutBonus(Match, Map, TmpBonus);
+		}
 	}
 
-	return NbLine;
-}//GetMaxLine
+	else if (2 == Difficulty) { /*HARD*/
 
- /*!
- * \brief Get the total of columns of a specific text file
- * \param[in] File File to read in
- * \return Total of "File" columns
- */
 
-unsigned GetMaxColumn(const string & File) {
-	string Line;
-	ifstream ReadedMap(File);
-	//Retourne la taille de la première ligne du fichier
-	getline(ReadedMap, Line);
-	return Line.length();
+		for (unsigned i(0); i < NbObs; ++i) {
+
+			unsigned MinX = round((Rules.m_sizeX / 2)) - Random.Range(1, 3);
+			unsigned MaxX = round((Rules.m_sizeX / 2)) + Random.Range(1, 2);
+			unsigned MinY = round((Rules.m_sizeY / 2)) - Random.Range(3, 4);
+			unsigned MaxY = round((Rules.m_sizeY / 2)) + Random.Range(2, 3);
+
+			unsigned RndX = round(Random.Range(MinX, MaxX));
+			unsigned RndY = round(Random.Range(MinY, MaxY));
+
+			TmpObs = InitObstacle(RndX, RndY, Rules.m_caseObstacle);
+
 
-}//GetMaxColumn
+			if ((Match.m_playerX.m_X == TmpObs.m_X && Match.m_playerX.m_Y == TmpObs.m_Y)
+				&& Match.m_playerY.m_X == TmpObs.m_X && Match.m_playerY.m_Y == TmpObs.m_Y) {
+				--i;
+				continue;
+			}
 
- /*!
- * \brief Initiate values to an empty matrix
- * \param[in] NbLine The matrix size (axe Y)
- * \param[in] NbColumn The matrix size (axe X)
- * \param[in] PlayerX The first player that will be put on the matrice
- * \param[in] PlayerY The second player that will be put on the matrice
- * \param[in] ShowBorder Creating borders or not
- * \return The completed matrix
- */
+			else {
+				if (!(IsSurrounded(Rules, Map, Match.m_playerX)) || !(IsSurrounded(Rules, Map, Match.m_playerY)))
+					GenerateRandomObstacles(Match, Map, TmpObs, Random.Range(2, 5));
+			}
+		}
 
-CMatrice InitMatrice(unsigned NbLine, unsigned NbColumn, SPlayer & PlayerX, SPlayer & PlayerY, bool ShowBorder = true) {
-	CMatrice Matrice;
-	Matrice.resize(NbLine);
 
-	for (unsigned i(0); i < NbLine; ++i)
-		for (unsigned j(0); j < NbColumn; ++j)
-			Matrice[i].push_back(CaseEmpty);
+		RndBX = Random.Range(round(Rules.m_sizeX - round(Rules.m_sizeX / 3)) - Random.Range(1, 3), round(Rules.m_sizeX - round(Rules.m_sizeX / 5)));
+		RndBY = Random.Range(round(Rules.m_sizeY - round(Rules.m_sizeY / 3)) - Random.Range(1, 3), round(Rules.m_sizeY - round(Rules.m_sizeY / 5)));
 
+		for (unsigned i(0); i < NbBonus; ++i) {
+			Choix = Random.Range(1, 3);
 
+			if (1 == Choix)  TmpBonus = InitBonus(RndBX - 1, RndBY, Rules.m_bonusY);
+			else if (2 == Choix) TmpBonus = InitBonus(RndBX - 1, RndBY, Rules.m_bonusX);
+			else if (3 == Choix) TmpBonus = InitBonus(RndBX - 1, RndBY, Rules.m_bonusZ);
 
-	for (unsigned i(PlayerX.m_Y); i < PlayerX.m_Y + PlayerX.m_sizeY; ++i)
-		for (unsigned j(PlayerX.m_X); j < PlayerX.m_X + PlayerX.m_sizeX; ++j)
-			Matrice[i][j] = PlayerX.m_token;
+			PutBonus(Match, Map, TmpBonus);
+		}
+	}
+	else cout << '\r' << endl << "[!] Vérifiez vos options, le difficulté doit être comprise entre 1 (facile) et 2 (difficile)" << endl;
 
 
-	for (unsigned i(PlayerY.m_Y); i < PlayerY.m_Y + PlayerY.m_sizeY; ++i)
-		for (unsigned j(PlayerY.m_X); j < PlayerY.m_X + PlayerY.m_sizeX; ++j)
-			Matrice[i][j] = PlayerY.m_token;
+}//GenerateStaticObject
 
-	if (ShowBorder) {
-		for (unsigned i(0); i < NbLine; ++i) {
+/*!
+* \brief Check if a case can be reached from another one through the cases that are not obstacles (flood fill, each case visited once)
+*
+* Le tour de la carte (bordure) n'est jamais parcouru. Chaque case n'entre qu'une fois dans la pile et ses voisines y sont
+* ajoutées sans branchement : sur une carte au hasard, un test par voisine serait une erreur de prédiction sur deux.
+* \param[in] Rules Rules of the game (obstacle and border tokens)
+* \param[in] Map The game map
+* \param[in] FromX Position X of the start case
+* \param[in] FromY Position Y of the start case
+* \param[in] ToX Position X of the case to reach
+* \param[in] ToY Position Y of the case to reach
+* \return True if a path exists
+*/
 
-			Matrice[i][0] = CaseBorder;
-			Matrice[i][NbColumn - 1] = CaseBorder;
+bool IsReachable(const SRules & Rules, const CMatrice & Map, const unsigned FromX, const unsigned FromY, const unsigned ToX, const unsigned ToY) {
+	const unsigned Width(Map.NbColumn()), Height(Map.NbLine());
+	if (FromX < 1 || FromY < 1 || FromX + 1 >= Width || FromY + 1 >= Height) return false;
+	if (ToX < 1 || ToY < 1 || ToX + 1 >= Width || ToY + 1 >= Height) return false;
+
+	/* 1 : case fermée (obstacle, bordure ou déjà empilée) */
+	const char * Cases = Map.Data();
+	vector <unsigned char> IsClosed(Map.NbCase());
+	for (size_t i(0); i < Map.NbCase(); ++i) IsClosed[i] = (Rules.m_caseObstacle == Cases[i]) | (Rules.m_caseBorder == Cases[i]);
+	for (unsigned Line(0); Line < Height; ++Line) IsClosed[size_t(Line) * Width] = IsClosed[size_t(Line) * Width + Width - 1] = 1;
+	fill(IsClosed.begin(), IsClosed.begin() + Width, 1);
+	fill(IsClosed.end() - Width, IsClosed.end(), 1);
+
+	const size_t Target = size_t(ToY) * Width + ToX;
+	vector <size_t> Stack(Map.NbCase() + 1);
+	size_t Top(0);
+	Stack[Top++] = size_t(FromY) * Width + FromX;
+	IsClosed[Stack[0]] = 1;
+
+	while (0 != Top) {
+		const size_t Case = Stack[--Top];
+		if (Target == Case) return true;
+
+		const size_t Next[4] = { Case - 1, Case + 1, Case - Width, Case + Width };
+		for (const size_t Neighbour : Next) {
+			Stack[Top] = Neighbour;
+			Top += 1 - IsClosed[Neighbour];
+			IsClosed[Neighbour] = 1;
 		}
+	}
+	return false;
+}//IsReachable()
+
+/*!
+* \brief Fill the whole map with obstacles and bonus at the densities of the rules, the second player staying reachable from the first one
+*
+* Chaque case vide tire un seul nombre : obstacle, bonus ou case vide selon les pourcentages m_obstacleDensity et m_bonusDensity.
+* Si les deux joueurs sont séparés, un chemin au hasard est creusé de l'un à l'autre ; les calques et la liste d'obstacles
+* sont reconstruits en une passe à la fin.
+* \param[in] Match The game, players placed
+* \param[in] Map Map where objects will be put on (empty cases, players and border)
+*/
 
-		for (unsigned i(0); i < NbColumn; ++i) {
-			Matrice[0][i] = CaseBorder;
-			Matrice[NbLine - 1][i] = CaseBorder;
+void GenerateDensityMap(SMatch & Match, CMatrice & Map) {
+
+	const SRules & Rules = Match.m_rules;
+	const char Bonus[3] = { Rules.m_bonusX, Rules.m_bonusY, Rules.m_bonusZ };
+	const uint64_t ObstacleLimit = (uint64_t(min(Rules.m_obstacleDensity, 100U)) << 32) / 100;
+	const uint64_t BonusLimit = ObstacleLimit + (uint64_t(min(Rules.m_bonusDensity, 100U - min(Rules.m_obstacleDensity, 100U))) << 32) / 100;
+	const char Empty(Rules.m_caseEmpty), Obstacle(Rules.m_caseObstacle);
+	const unsigned NbLine(Map.NbLine()), NbColumn(Map.NbColumn());
+	CRandom & Random = Match.m_random;
+
+	/* Copie locale du moteur : les écritures dans la carte (char *) obligeraient sinon à relire son état à chaque case */
+	CRandom Local = Random;
+	for (unsigned Line(1); Line + 1 < NbLine; ++Line) {
+		char * Row = Map[Line];
+		for (unsigned Column(1); Column + 1 < NbColumn; ++Column) {
+			if (Empty != Row[Column]) continue;
+
+			/* Sans branchement : le tirage est imprévisible */
+			const uint64_t Draw = Local.Next();
+			const char Picked[3] = { Obstacle, Bonus[((Draw & 0xFFFFFFFF) * 3) >> 32], Empty };
+			Row[Column] = Picked[((Draw >> 32) >= ObstacleLimit) + ((Draw >> 32) >= BonusLimit)];
 		}
+	}
+	Random = Local;
+
+	SPlayer & From = Match.m_playerX;
+	const SPlayer & To = Match.m_playerY;
+
+	if (!IsReachable(Rules, Map, From.m_X, From.m_Y, To.m_X, To.m_Y)) {
+		/* Marche au hasard vers le second joueur : chaque pas le rapproche, les obstacles du chemin sont retirés */
+		unsigned X(From.m_X), Y(From.m_Y);
+		while (X != To.m_X || Y != To.m_Y) {
+			const bool IsStepX = (Y == To.m_Y || (X != To.m_X && 0 == Random.Range(0, 1)));
+			if (IsStepX) X = (X < To.m_X ? X + 1 : X - 1);
+			else Y = (Y < To.m_Y ? Y + 1 : Y - 1);
 
+			if (Rules.m_caseObstacle == Map[Y][X]) Map[Y][X] = Rules.m_caseEmpty;
+		}
 	}
 
+	const unsigned Width(Map.NbColumn()), Height(Map.NbLine());
+	const SMapScan Scan = ResetLayers(Match, Map, true);
 
-	return Matrice;
-} //InitMatrice()
+	/* La bordure n'est pas un obstacle de la partie */
+	Match.m_obstacleLayer.FillRect(0, 0, 1, Width, false);
+	Match.m_obstacleLayer.FillRect(Height - 1, 0, 1, Width, false);
+	Match.m_obstacleLayer.FillRect(0, 0, Height, 1, false);
+	Match.m_obstacleLayer.FillRect(0, Width - 1, Height, 1, false);
 
-  /*!
-  * \brief Show matrix on console
-  * \param[in] Matrice The matrix to display
-  * \param[in] Clear Optional boolean that will clear or not the console
-  */
+	Match.m_obstacles.reserve(Scan.m_nbObstacle);
+	Match.m_obstacleLayer.ForEachCase([&](const unsigned X, const unsigned Y) {
+		Match.m_obstacles.push_back(InitObstacle(X, Y, Rules.m_caseObstacle));
+	});
 
-void ShowMatrice(const CMatrice & Matrice, const bool Clear = true) {
+}//GenerateDensityMap()
 
-	if (Clear) ClearScreen();
-	PrintLines(2);
-	Couleur(KReset);
+// PLAYERS
 
-	for (unsigned i(0); i < Matrice.size(); ++i) {
-		SetTextMiddle();
-		for (unsigned a(0); a < Matrice[i].size(); ++a) {
+/*!
+* \brief Check if player got the bonus that make his size up
+* \param[in] Player Player to check
+* \return Return true if the bonus was taken
+*/
 
-			/*GESTION DES CoulEURS*/
-			if (Matrice[i][a] == CaseObstacle) {
-				Couleur(KBold);
-				Couleur(KHNoir);
-			}
+bool IsBonusTaken(const SPlayer & Player) {
+	return (1 == Player.m_sizeX ? false : true);
+}//IsBonusTaken()
 
-			if (Matrice[i][a] == BonusX)
-				Couleur(KVert, KHVert);
+ /*!
+ * \brief Initiate values to an empty player
+ * \param[in] Largeur Player's width
+ * \param[in] Hauteur Player's height
+ * \param[in] AxeX Position X of player
+ * \param[in] AxeY Position Y of player
+ * \param[in] Token player token
+ * \return Final player
+ */
 
-			if (Matrice[i][a] == BonusY)
-				Couleur(KVert, KHVert);
+SPlayer InitPlayer(const unsigned Largeur, const unsigned Hauteur, const unsigned  AxeX, const unsigned  AxeY, const char  Token) {
 
-			if (Matrice[i][a] == BonusZ)
-				Couleur(KVert, KHVert);
+	SPlayer Player;
 
-			if (Matrice[i][a] == TokenPlayerX) {
-				Couleur(KBold);
-				Couleur(KRouge, KHCyan);
-			}
+	Player.m_sizeX = Largeur;
+	Player.m_sizeY = Hauteur;
+	Player.m_X = AxeX;
+	Player.m_Y = AxeY;
+	Player.m_token = Token;
+	/*Constant values below*/
+	Player.m_score = 0;
 
-			if (Matrice[i][a] == TokenPlayerY) {
-				Couleur(KBold);
-				Couleur(KBleu, KHJaune);
-			}
+	return Player;
+}//InitPlayer()
 
-			if (Matrice[i][a] == CaseEmpty)
-				Couleur(KMagenta);
+ /*!
+ * \brief Get the edge a player enters with a movement : the line or the column on the side of the movement
+ * \param[in] Rules Rules of the game (movement keys)
+ * \param[in] Player The player, already moved
+ * \param[in] Move The movement
+ * \param[out] Line First line of the edge
+ * \param[out] Column First column of the edge
+ * \param[out] Height Edge height
+ * \param[out] Width Edge width
+ * \return False if Move is not a movement key
+ */
 
-			cout << Matrice[i][a];
-			Couleur(KReset);
+bool GetEnteredEdge(const SRules & Rules, const SPlayer & Player, const char Move, unsigned & Line, unsigned & Column, unsigned & Height, unsigned & Width) {
 
-		}
+	Line = Player.m_Y;
+	Column = Player.m_X;
+	Height = 1;
+	Width = 1;
 
-		cout << endl;
+	if (Move == Rules.m_mouvTop || Move == Rules.m_mouvBot) {
+		if (Move == Rules.m_mouvBot) Line += Player.m_sizeY - 1;
+		Width = Player.m_sizeX;
 	}
-}//ShowMatrice
+	else if (Move == Rules.m_mouvLeft || Move == Rules.m_mouvRight) {
+		if (Move == Rules.m_mouvRight) Column += Player.m_sizeX - 1;
+		Height = Player.m_sizeY;
+	}
+	else return false;
+
+	return true;
+}//GetEnteredEdge()
 
  /*!
- * \brief Load map by file
- * \param[in] MapName The map to load
- * \return Loaded matrix
+ * \brief Get the layer of a player
+ * \param[in] Match The game
+ * \param[in] Player The player
+ * \return The layer, null if Player is not one of the two players of the game (editor cursor...)
  */
 
-CMatrice LoadMapByFile(const string & MapName) {
+CBitBoard * GetPlayerLayer(SMatch & Match, const SPlayer & Player) {
+	if (&Player == &Match.m_playerX) return &Match.m_playerLayerX;
+	if (&Player == &Match.m_playerY) return &Match.m_playerLayerY;
+	return nullptr;
+}//GetPlayerLayer()
 
-	const string FullName = "./map/MyMap_" + MapName + ".map";
-	unsigned NbLine = GetMaxLine(FullName);
-	unsigned NbColumn = GetMaxColumn(FullName);
-	CMatrice LoadedMatrice = InitMatrice(NbLine, NbColumn, PlayerX, PlayerY);
+ /*!
+ * \brief Put a player (or empty cases) on a rectangle of the map and of the player layer (bonus under it are not cleared)
+ * \param[in] Match The game
+ * \param[in] Matrice The game map
+ * \param[in] Player The player
+ * \param[in] Line First line of the rectangle
+ * \param[in] Column First column of the rectangle
+ * \param[in] Height Rectangle height
+ * \param[in] Width Rectangle width
+ * \param[in] IsPlayer Put the player (true) or empty cases (false)
+ */
 
-	vector <string> MapLines;
-	string ReadedLine;
-	ifstream ifs(FullName);
+template <typename TMatrice>
+void FillPlayerRect(SMatch & Match, TMatrice & Matrice, const SPlayer & Player, const unsigned Line, const unsigned Column, const unsigned Height, const unsigned Width, const bool IsPlayer) {
 
-	while (!ifs.eof()) {
+	Matrice.FillRect(Line, Column, Height, Width, IsPlayer ? Player.m_token : Match.m_rules.m_caseEmpty);
 
-		getline(ifs, ReadedLine);
-		if (!(ReadedLine == "\n\r" || ReadedLine[0] == '\n'))
-			MapLines.push_back(ReadedLine);
-	}
+	CBitBoard * Layer = GetPlayerLayer(Match, Player);
+	if (nullptr != Layer) Layer->FillRect(Line, Column, Height, Width, IsPlayer);
+}//FillPlayerRect()
+
+ /*!
+ * \brief Move player to a specific position
+ * \param[in] Match The game
+ * \param[in] Matrice Game map (CMatrice or CChunkedMatrice)
+ * \param[in] Move Player's movement
+ * \param[in] Player Player to move
+ */
 
-	ifs.clear();
+template <typename TMatrice>
+void MovePlayer(SMatch & Match, TMatrice & Matrice, char Move, SPlayer & Player) {
 
-	for (unsigned i(0); i < LoadedMatrice.size(); ++i) {
-		for (unsigned a(0); a < LoadedMatrice[i].size(); ++a) {
-			LoadedMatrice[i][a] = MapLines[i][a];
+	unsigned Additional(0);
+	if (IsMovementForbidden(Match, Player, Move)) return;
+	Player.m_history.push_back(toupper(Move));
+	if (IsBonusTaken(Player)) Additional = 1;
 
+	/* Le bord quitté est vidé, GetBonus() marque le bord d'entrée */
+	if (Move == Match.m_rules.m_mouvTop) {
+		if (Player.m_Y + Player.m_sizeY > 2 + Additional)
+		{
+			FillPlayerRect(Match, Matrice, Player, Player.m_Y + Player.m_sizeY - 1, Player.m_X, 1, Player.m_sizeX, false);
+			--Player.m_Y;
+			GetBonus(Match, Matrice, Player, Move);
 		}
 	}
 
-	return LoadedMatrice;
-}
-
-// WIN CHECK - WIN STAT
 
-/*!
-* \brief Check if someone  won
-* \param[in] PlayerX The first player
-* \param[in] PlayerY The second player
-* \return If PlayerX or PlayerY won
-*/
+	else if (Move == Match.m_rules.m_mouvBot) {
 
-bool CheckIfWin(SPlayer & PlayerX, SPlayer & PlayerY) {
-	return !((PlayerX.m_X > PlayerY.m_X + PlayerY.m_sizeX - 1) ||
-		(PlayerX.m_X + PlayerX.m_sizeX - 1 < PlayerY.m_X) ||
-		(PlayerY.m_Y > PlayerX.m_Y + PlayerX.m_sizeY - 1) ||
-		(PlayerY.m_Y + PlayerY.m_sizeY - 1 < PlayerX.m_Y));
-} //CheckIfWin()
+		if (Player.m_Y + Player.m_sizeY < Matrice.NbLine() - 1) {
+			FillPlayerRect(Match, Matrice, Player, Player.m_Y, Player.m_X, 1, Player.m_sizeX, false);
+			++Player.m_Y;
+			GetBonus(Match, Matrice, Player, Move);
+		}
+	}
 
-/*!
-* \brief Get the game winner
-* \param[in] PlayerX The first player
-* \param[in] PlayerY The second player
-* \param[in] NbrTour The final round number
-* \return The game winner
-*/
+	else if (Move == Match.m_rules.m_mouvLeft) {
+		if (Player.m_X + Player.m_sizeY > 2 + Additional)
+		{
+			FillPlayerRect(Match, Matrice, Player, Player.m_Y, Player.m_X + Player.m_sizeX - 1, Player.m_sizeY, 1, false);
+			--Player.m_X;
+			GetBonus(Match, Matrice, Player, Move);
+		}
+	}
 
-SPlayer GetWinner(const SPlayer& PlayerX, const SPlayer &PlayerY, const unsigned & NbrTour) {
-	return (NbrTour % 2 == 0 ? PlayerX : PlayerY);
-} //GetWinner()
+	else if (Move == Match.m_rules.m_mouvRight) {
+		if (Player.m_X + Player.m_sizeX < Matrice.NbColumn() - 1)
+		{
+			FillPlayerRect(Match, Matrice, Player, Player.m_Y, Player.m_X, Player.m_sizeY, 1, false);
+			++Player.m_X;
+			GetBonus(Match, Matrice, Player, Move);
+		}
+	}
+}//MovePlayer()
 
 /*!
-* \brief Display win screen
-* \param[in] The final round number
-* \param[in] IsBot (Optional) Is the game agains't IA
+* \brief Check if a key is a movement key
+* \param[in] Rules Rules of the game (movement keys)
+* \param[in] Key The key
+* \return True if Key moves a player
 */
 
-void DisplayWin(const unsigned &Tour, const bool &IsBot = true) {
-
-	SPlayer Winner = GetWinner(PlayerX, PlayerY, Tour);
+bool IsMoveKey(const SRules & Rules, const int Key) {
+	return Key == Rules.m_mouvTop || Key == Rules.m_mouvBot || Key == Rules.m_mouvLeft || Key == Rules.m_mouvRight;
+}//IsMoveKey()
 
-	if (IsBot)
-		ClearScreen();
+ /*!
+ * \brief Move player to the position depending of what he typed
+ * \param[in] ch Entered key
+ * \param[in] Map Game's map
+ * \param[in] Player Player to move
+ */
 
+void KeyEvent(const int & ch, CMatrice & Map, SPlayer & Player) {
 
-	PrintLines(1);
-	Couleur(KRouge, KHCyan);
+	if (ch == CMouvTop)
+		MovePlayer(Game, Map, CMouvTop, Player);
+	else if (ch == CMouvBot)
+		MovePlayer(Game, Map, CMouvBot, Player);
+	else if (ch == CMouvLeft)
+		MovePlayer(Game, Map, CMouvLeft, Player);
+	else if (ch == CMouvRight)
+		MovePlayer(Game, Map, CMouvRight, Player);
+	else if (ch == char(3)/*CTRL+C*/) {
+		cout << endl;
+		endwin();
+		exit(0);
+	}
 
-	PrintLines(6);
-	cout << endl << endl << "[!] Le joueur '" << Winner.m_token << "' a gagné avec : ";
+}//KeyEvent()
 
-	Couleur(KHBleu, KHGris); cout << Winner.m_score;
-	Couleur(KRouge, KHCyan); cout << " points" << '!' << endl << '\r';
+// IA (BOT)
 
-	if (BShowHistory) {
-		PrintLines(3);
-		Couleur(KRouge, KHJaune);
 
-		cout << "Historique du gagnant : \n\r" << endl << "n° | Mouv \n\r" << "________\n\r";
+/*!
+* \brief Choose the bot movement
+*
+* Le bot suit le plus court chemin vers sa cible. S'il n'en existe pas, ou s'il peut traverser
+* les obstacles (bonus de taille), il se rapproche alternativement en X et en Y.
+* \param[in] Match The game
+* \param[in] Finder The bot path
+* \param[in] Map Game map
+* \param[in] Bot The bot
+* \param[in] Target The player to catch
+* \param[in] Tour Number of moves already played by the bot
+* \return The movement key, 0 if the bot stays
+*/
+char GetBotMove(const SMatch & Match, CPathFinder & Finder, const CMatrice & Map, const SPlayer & Bot, const SPlayer & Target, const unsigned Tour) {
 
-		for (unsigned i(0); i < Winner.m_history.size(); ++i)
-			cout << "| " << i << " | " << Winner.m_history[i] << " | " << "\n\r";
+	unsigned NextX, NextY;
 
+	if (1 == Bot.m_sizeX && Finder.NextStep(Map, Match.m_obstacleLayer, Match.m_rules, Bot, Target, NextX, NextY)) {
+		if (NextY < Bot.m_Y) return Match.m_rules.m_mouvTop;
+		if (NextY > Bot.m_Y) return Match.m_rules.m_mouvBot;
+		if (NextX < Bot.m_X) return Match.m_rules.m_mouvLeft;
+		return Match.m_rules.m_mouvRight;
 	}
 
-	Couleur(KReset);
-	endwin();
-	return;
-} //DisplayWin()
+	if (1 == Tour % 2 && (!(Target.m_X == Bot.m_X)))
+		return (Bot.m_X - 1 < Target.m_X ? Match.m_rules.m_mouvRight : Match.m_rules.m_mouvLeft);
 
-// BONUS
+	if (!(Target.m_Y == Bot.m_Y))
+		return ((Bot.m_Y - 1) < Target.m_Y ? Match.m_rules.m_mouvBot : Match.m_rules.m_mouvTop);
+
+	return 0;
+}//GetBotMove()
 
 /*!
-* \brief Initiate values to an empty bonus
-* \param[in] AxeX Position X of bonus
-* \param[in] AxeY Position Y of bonus
-* \param[in] Token Bonus token
-* \return Final bonus
+* \brief Move bot (second player) to a specific position
+* \param[in] Match The game
+* \param[in] Map Game map
+* \param[in] Tour Actual round
+* \return The movement key, 0 if the bot stays
 */
+char MoveBot(SMatch & Match, CMatrice & Map, const unsigned & Tour) {
 
-SBonus InitBonus(const unsigned AxeX, const unsigned AxeY, const char Token) {
+	const char Move = GetBotMove(Match, Match.m_botPath, Map, Match.m_playerY, Match.m_playerX, Tour);
+	if (0 != Move) MovePlayer(Match, Map, Move, Match.m_playerY);
+	return Move;
 
-	SBonus Bonus;
+}//MoveBot()
 
-	Bonus.m_X = AxeX;
-	Bonus.m_Y = AxeY;
-	Bonus.m_token = Token;
+// SIMULATION
 
-	return Bonus;
-}//InitBonus()
- /*!
- * \brief Put bonus to matrix
- * \param[in] Matrice Matrix where the bonus will be put on
- * \param[in] Bonus Bonus to put
- */
+/*!
+* \brief Alias to a move policy : returns the movement key of Self (0 to stay)
+*
+* Paramètres : la partie, la carte, le joueur qui joue, son adversaire et le nombre de coups déjà joués par ce joueur.
+*/
+typedef function <char (SMatch &, const CMatrice &, const SPlayer &, const SPlayer &, const unsigned)> FMovePolicy;
 
-void PutBonus(CMatrice & Matrice, SBonus & Bonus) {
-	if ((Bonus.m_Y > 1 && Bonus.m_X > 1) && (Bonus.m_Y < KSizeY - 1 && Bonus.m_X < KSizeX - 1))
-		Matrice[Bonus.m_Y][Bonus.m_X] = Bonus.m_token;
-}//PutBonus()
+/*!
+* \brief Alias to a policy factory : each game gets new policies (no state shared between games)
+*/
+typedef function <FMovePolicy ()> FPolicyMaker;
 
- /*!
- * \brief Check if player get bonus
- * \param[in] Matrice The game map
- * \param[in] Player The player to check
- */
-void GetBonus(CMatrice & Matrice, SPlayer & Player) {
-	for (unsigned i(Player.m_Y); i < Player.m_Y + Player.m_sizeY; ++i) {
-		for (unsigned j(Player.m_X); j < Player.m_X + Player.m_sizeX; ++j) {
-			//Début de la détéction des bonus
+/**
+* \struct SMatchResult
+* \brief Résultat d'une partie simulée.
+*
+* La structure SMatchResult contient la graine de la partie (m_seed), le token du gagnant (m_winner, 0 si personne
+* n'a été attrapé), le nombre de tours joués (m_nbTour) et les deux joueurs en fin de partie (scores et historiques).
+*/
+typedef struct {
+	uint64_t m_seed;
+	char m_winner;
+	unsigned m_nbTour;
+	SPlayer m_playerX;
+	SPlayer m_playerY;
+} SMatchResult;
 
-			if (Matrice[i][j] == BonusX) {
+/**
+* \struct SBatchResult
+* \brief Statistiques d'une série de parties simulées.
+*
+* La structure SBatchResult compte les parties jouées (m_nbMatch), gagnées par chaque joueur (m_winX, m_winY)
+* ou sans vainqueur (m_draw), et cumule les tours joués (m_nbTour) et les scores (m_scoreX, m_scoreY).
+*/
+typedef struct {
+	unsigned m_nbMatch;
+	unsigned m_winX;
+	unsigned m_winY;
+	unsigned m_draw;
+	uint64_t m_nbTour;
+	int64_t m_scoreX;
+	int64_t m_scoreY;
+} SBatchResult;
 
-				if (Player.m_X == 1) SLog += "\n\rVous avez déjà prit un bonus de ce type !";
-				++Player.m_sizeX;
-				++Player.m_sizeY;
-				SLog += "\n\rVotre taille a augmenté!. \n\rVous pouvez désormé traverser les obstacles";
-				Player.m_score += 25;
-				SLog += "\n\r\n\rCe bonus vous a fait gagner 25 points!";
+/*!
+* \brief Policy following the shortest path to the other player (same as the bot)
+* \return The policy, with its own path cache
+*/
+FMovePolicy MakeChaserPolicy() {
+	shared_ptr <CPathFinder> Finder = make_shared <CPathFinder>();
 
-			}
+	return [Finder](SMatch & Match, const CMatrice & Map, const SPlayer & Self, const SPlayer & Other, const unsigned Tour) {
+		return GetBotMove(Match, *Finder, Map, Self, Other, Tour);
+	};
+}//MakeChaserPolicy()
 
-			if (Matrice[i][j] == BonusY) {
+/*!
+* \brief Policy moving in a random direction
+*
+* La politique a son propre générateur, initialisé avec la graine de la partie : elle ne consomme pas les tirages
+* de la partie (bonus), qu'un rejeu des seuls coups enregistrés doit retrouver.
+* \return The policy
+*/
+FMovePolicy MakeRandomPolicy() {
+	shared_ptr <CRandom> Random = make_shared <CRandom>();
 
-				Player.m_score += 15;
-				SLog += "\n\r\n\rCe bonus ne fait strictement rien\n\rExcepté vous faire gagner 15 points!";
+	return [Random](SMatch & Match, const CMatrice &, const SPlayer &, const SPlayer &, const unsigned) {
+		const char Moves[4] = { Match.m_rules.m_mouvTop, Match.m_rules.m_mouvBot, Match.m_rules.m_mouvLeft, Match.m_rules.m_mouvRight };
 
+		if (Random->GetSeed() != Match.m_random.GetSeed()) Random->SetSeed(Match.m_random.GetSeed());
+		return Moves[Random->Range(0, 3)];
+	};
+}//MakeRandomPolicy()
 
-			}
+/*!
+* \brief Generate a new game map and place both players (first player top left, second player bottom right)
+* \param[in] Match The game
+* \return The game map
+*/
+CMatrice GenerateGameMap(SMatch & Match) {
 
-			if (Matrice[i][j] == BonusZ) {
+	const SRules & Rules = Match.m_rules;
 
-				SLog += "\n\rDes obstacles aléatoires ont été placés!";
-				Player.m_score += 10;
-				SLog += "\n\r\n\rCe bonus vous a fait gagner 10 points!";
-				GenerateStaticObject(Matrice, KDifficult, 2, 1);
+	Match.m_playerX = InitPlayer(1, 1, 1, 1, Rules.m_tokenPlayerX);
+	Match.m_playerY = InitPlayer(1, 1, Rules.m_sizeX - 1, Rules.m_sizeY - 1, Rules.m_tokenPlayerY);
 
-			}
+	CMatrice Map = InitMatrice(Rules, Rules.m_sizeY + 1, Rules.m_sizeX + 1, Match.m_playerX, Match.m_playerY); /* +1 due à la bordure de '#' le long de la Matrice */
+	ResetLayers(Match, Map);
 
-			//Fin de la détéction des bonus
-			for (unsigned i(Player.m_Y); i < Player.m_Y + Player.m_sizeY; ++i)
-				for (unsigned j(Player.m_X); j < Player.m_X + Player.m_sizeX; ++j)
-					Matrice[i][j] = Player.m_token;
-		}
-	}
-}//GetBonus()
+	if (0 != Rules.m_obstacleDensity || 0 != Rules.m_bonusDensity)
+		GenerateDensityMap(Match, Map);
+	else if (Rules.m_difficult == 1)
+		GenerateStaticObject(Match, Map, Match.m_rules.m_difficult, 6, 5);
+	else
+		GenerateStaticObject(Match, Map, Match.m_rules.m_difficult, Match.m_random.Range(7, 9), 4);
 
-// OBSTACLES
+	return Map;
+}//GenerateGameMap()
 
 /*!
-* \brief Check if player is surrounded of obstacles
-* \param[in] Matrice The game map
-* \param[in] Player The player to check
-* \return True if player is surrounded
+* \brief Play a whole game without any display
+*
+* Les joueurs jouent chacun leur tour (le premier d'abord) avec les mêmes règles que DisplaySoloIA().
+* La partie a son propre état (SMatch) : plusieurs parties peuvent être jouées en même temps.
+* \param[in] Rules Rules of the game
+* \param[in] Seed The game seed (same seed and policies : same game)
+* \param[in] NbRound Maximum number of rounds
+* \param[in] PolicyX First player moves
+* \param[in] PolicyY Second player moves
+* \param[out] Replay If not null, the game is recorded there
+* \return The game result
 */
-bool IsSurrounded(CMatrice & Map, SPlayer & Player) {
-	return (Map[Player.m_X + 1][Player.m_Y + 1] == CaseObstacle);
-}//IsSurrounded()
+SMatchResult RunMatch(const SRules & Rules, const uint64_t Seed, const unsigned NbRound, const FMovePolicy & PolicyX, const FMovePolicy & PolicyY,
+	SReplay * Replay = nullptr) {
 
+	SMatch Match;
+	SMatchResult Result;
 
-/*!
-* \brief Initiate values to an empty obstacle
-* \param[in] AxeX Position X of obstacle
-* \param[in] AxeY Position Y of obstacle
-* \param[in] Token obstacle token
-* \return Final obstacle
-*/
+	Result.m_seed = InitMatch(Match, Rules, Seed);
+	Result.m_winner = 0;
+	Result.m_nbTour = NbRound * 2;
 
-SObstacle InitObstacle(const unsigned
-	AxeX, const unsigned AxeY, const char Token) {
+	CMatrice Map = GenerateGameMap(Match);
+	if (nullptr != Replay) StartReplay(*Replay, Match, Map);
+
+	for (unsigned Tour(0); Tour < NbRound * 2; ++Tour) {
+		SPlayer & ActualPlayer = (Tour % 2 == 0 ? Match.m_playerX : Match.m_playerY);
+		const SPlayer & OtherPlayer = (Tour % 2 == 0 ? Match.m_playerY : Match.m_playerX);
+
+		const char Move = (Tour % 2 == 0 ? PolicyX : PolicyY)(Match, Map, ActualPlayer, OtherPlayer, Tour / 2);
+		if (0 != Move) MovePlayer(Match, Map, Move, ActualPlayer);
+		if (nullptr != Replay) RecordMove(*Replay, Match.m_rules, Tour % 2 == 0, Move);
+
+		if (CheckIfWin(Match)) {
+			Result.m_winner = GetWinner(Match.m_playerX, Match.m_playerY, Tour).m_token;
+			Result.m_nbTour = Tour + 1;
+			break;
+		}
+	}
+
+	Result.m_playerX = Match.m_playerX;
+	Result.m_playerY = Match.m_playerY;
 
-	SObstacle Obstacle;
+	if (nullptr != Replay) {
+		Replay->m_winner = Result.m_winner;
+		Replay->m_nbTour = Result.m_nbTour;
+		Replay->m_scoreX = Result.m_playerX.m_score;
+		Replay->m_scoreY = Result.m_playerY.m_score;
+	}
 
-	Obstacle.m_X = AxeX;
-	Obstacle.m_Y = AxeY;
-	Obstacle.m_token = Token;
-	return Obstacle;
-} //InitObstacle()
+	return Result;
+}//RunMatch()
 
 /*!
-* \brief Put obstacle to matrix
-* \param[in] Matrice Matrix where the obstacle will be put on
-* \param[in] Obstacle Obstacle to put
+* \brief Play NbMatch games on a pool of threads
+*
+* La partie i utilise la graine FirstSeed + i et son propre générateur aléatoire : le résultat ne dépend
+* ni du nombre de threads ni de l'ordre dans lequel les parties sont jouées. Chaque thread prend la partie
+* suivante dans un compteur partagé et cumule ses statistiques à part ; elles sont additionnées à la fin.
+* \param[in] Rules Rules of the games
+* \param[in] FirstSeed Seed of the first game
+* \param[in] NbMatch Number of games
+* \param[in] NbRound Maximum number of rounds of a game
+* \param[in] NbThread Number of threads (0 : one by processor)
+* \param[in] MakePolicyX First player policies
+* \param[in] MakePolicyY Second player policies
+* \return The statistics of all the games
 */
+SBatchResult RunBatch(const SRules & Rules, const uint64_t FirstSeed, const unsigned NbMatch, const unsigned NbRound, unsigned NbThread,
+	const FPolicyMaker & MakePolicyX, const FPolicyMaker & MakePolicyY) {
+
+	if (0 == NbThread) NbThread = max(1u, thread::hardware_concurrency());
+	NbThread = max(1u, min(NbThread, NbMatch));
+
+	atomic <unsigned> NextMatch(0);
+	vector <SBatchResult> Partials(NbThread, SBatchResult{ 0, 0, 0, 0, 0, 0, 0 });
+	vector <thread> Workers;
+
+	for (unsigned t(0); t < NbThread; ++t) {
+		Workers.push_back(thread([&, t]() {
+			SBatchResult Partial = { 0, 0, 0, 0, 0, 0, 0 };
+
+			for (unsigned i(NextMatch++); i < NbMatch; i = NextMatch++) {
+				const SMatchResult Result = RunMatch(Rules, FirstSeed + i, NbRound, MakePolicyX(), MakePolicyY());
+
+				++Partial.m_nbMatch;
+				if (Result.m_winner == Rules.m_tokenPlayerX) ++Partial.m_winX;
+				else if (Result.m_winner == Rules.m_tokenPlayerY) ++Partial.m_winY;
+				else ++Partial.m_draw;
+				Partial.m_nbTour += Result.m_nbTour;
+				Partial.m_scoreX += Result.m_playerX.m_score;
+				Partial.m_scoreY += Result.m_playerY.m_score;
+			}
 
-void PutObstacle(CMatrice & Matrice, SObstacle & Obstacle) {
-
-	for (int i = -1; i < 1; ++i) {
-		if ((Matrice[Obstacle.m_Y + i][Obstacle.m_X + i] != (int)Matrice.size())) {
+			Partials[t] = Partial;	/* une seule écriture par thread dans le vecteur partagé */
+		}));
+	}
 
-			Matrice[Obstacle.m_Y][Obstacle.m_X] = Obstacle.m_token;
-			VObstacle.push_back(Obstacle);
-		}
+	SBatchResult Total = { 0, 0, 0, 0, 0, 0, 0 };
+
+	for (unsigned t(0); t < NbThread; ++t) {
+		Workers[t].join();
+		Total.m_nbMatch += Partials[t].m_nbMatch;
+		Total.m_winX += Partials[t].m_winX;
+		Total.m_winY += Partials[t].m_winY;
+		Total.m_draw += Partials[t].m_draw;
+		Total.m_nbTour += Partials[t].m_nbTour;
+		Total.m_scoreX += Partials[t].m_scoreX;
+		Total.m_scoreY += Partials[t].m_scoreY;
 	}
 
-} //PutObstacle()
+	return Total;
+}//RunBatch()
 
 /*!
-* \brief Generate random obstacles into matrix
-* \param[in] Matrice Matrix where the obstacle will be put on
-* \param[in] Obstacle Obstacle to put
-* \param[in] Totalsize Number of obstacle to put
+* \brief Print a simulated game result
+* \param[in] Result The game result
 */
+void ShowMatchResult(const SMatchResult & Result) {
 
-void GenerateRandomObstacles(CMatrice & Matrice, const SObstacle & Obstacle, const unsigned & Totalsize) {
-	SObstacle NewObstacle = Obstacle;
+	cout << "[+] Graine : " << Result.m_seed << endl;
+	cout << "[+] Tours joués : " << Result.m_nbTour << endl;
 
-	vector <unsigned> Randomvalues;
+	if (0 == Result.m_winner) cout << "[!] Egalité !" << endl;
+	else cout << "[!] Le joueur '" << Result.m_winner << "' a gagné !" << endl;
 
-	for (unsigned i(0); i < Totalsize; ++i) Randomvalues.push_back(Rand(1, 2));
+	const SPlayer * Players[2] = { &Result.m_playerX, &Result.m_playerY };
+	for (const SPlayer * Player : Players) {
+		cout << "[+] '" << Player->m_token << "' : " << Player->m_score << " points, historique : ";
+		cout << string(Player->m_history.begin(), Player->m_history.end()) << endl;
+	}
+}//ShowMatchResult()
 
-	for (unsigned i(0); i < Totalsize; ++i) {
+/*!
+* \brief Print the statistics of simulated games (win rates, average rounds and scores)
+* \param[in] Rules Rules of the games
+* \param[in] Result The statistics
+*/
+void ShowBatchResult(const SRules & Rules, const SBatchResult & Result) {
 
-		if (1 == Randomvalues[i]) {
-			++NewObstacle.m_Y;
-			PutObstacle(Matrice, NewObstacle);
-		}
-		else if (2 == Randomvalues[i]) {
-			++NewObstacle.m_X;
-			PutObstacle(Matrice, NewObstacle);
-		}
+	if (0 == Result.m_nbMatch) {
+		cout << "[!] Aucune partie jouée." << endl;
+		return;
 	}
-} //GenerateRandomObstacles()
+
+	const double NbMatch = Result.m_nbMatch;
+
+	cout << fixed << setprecision(2);
+	cout << "[+] Parties jouées : " << Result.m_nbMatch << endl;
+	cout << "[+] Victoires '" << Rules.m_tokenPlayerX << "' : " << 100.0 * Result.m_winX / NbMatch << " %" << endl;
+	cout << "[+] Victoires '" << Rules.m_tokenPlayerY << "' : " << 100.0 * Result.m_winY / NbMatch << " %" << endl;
+	cout << "[+] Egalités : " << 100.0 * Result.m_draw / NbMatch << " %" << endl;
+	cout << "[+] Tours joués en moyenne : " << Result.m_nbTour / NbMatch << endl;
+	cout << "[+] Scores moyens : '" << Rules.m_tokenPlayerX << "' " << Result.m_scoreX / NbMatch
+		<< ", '" << Rules.m_tokenPlayerY << "' " << Result.m_scoreY / NbMatch << endl;
+	cout << defaultfloat;
+}//ShowBatchResult()
+
+// REPLAY
 
 /*!
-* \brief Check if player can move to the position he decided to go
-* \param[in] Player Player to check
-* \param[in] Movement The movement that the player will do
-* \return True if player can move to his future movement
+* \brief Start recording a game : rules, players, map, obstacles and random engine state before the first move
+* \param[out] Replay The record
+* \param[in] Match The game, ready to be played
+* \param[in] Map The game map
 */
+void StartReplay(SReplay & Replay, const SMatch & Match, const CMatrice & Map) {
+
+	Replay.m_seed = Match.m_random.GetSeed();
+	Match.m_random.GetState(Replay.m_state);
+	Replay.m_rules = Match.m_rules;
+	Replay.m_playerX = Match.m_playerX;
+	Replay.m_playerY = Match.m_playerY;
+	Replay.m_map = Map;
+	Replay.m_obstacles = Match.m_obstacles;
+	Replay.m_moves.clear();
+	Replay.m_winner = 0;
+	Replay.m_nbTour = 0;
+	Replay.m_scoreX = 0;
+	Replay.m_scoreY = 0;
+}//StartReplay()
 
-bool IsMovementForbidden(SPlayer & Player, char & Movement) {
-	if (Player.m_sizeX != 1) return false;
+/*!
+* \brief Record one move ('.' if it is not a movement key)
+*
+* Si le même joueur joue deux fois de suite (temps réel), un '.' est enregistré pour l'autre entre les deux.
+* \param[in] Replay The record
+* \param[in] Rules Rules of the game (movement keys)
+* \param[in] IsPlayerX True if the first player moved
+* \param[in] Move The played key
+*/
+void RecordMove(SReplay & Replay, const SRules & Rules, const bool IsPlayerX, const int Move) {
+	if ((Replay.m_moves.size() % 2 == 0) != IsPlayerX) Replay.m_moves += '.';
+	Replay.m_moves += (IsMoveKey(Rules, Move) ? char(Move) : '.');
+}//RecordMove()
 
-	for (unsigned i(0); i < VObstacle.size(); ++i) {
-		if (VObstacle[i].m_X == Player.m_X  &&
-			VObstacle[i].m_Y == Player.m_Y - 1 && Movement == CMouvTop) {
+/*!
+* \brief Record the end of a game
+* \param[in] Replay The record
+* \param[in] Match The game
+* \param[in] NbTour Number of moves played
+*/
+void EndReplay(SReplay & Replay, SMatch & Match, const unsigned NbTour) {
+	Replay.m_winner = (0 != NbTour && CheckIfWin(Match) ? GetWinner(Match.m_playerX, Match.m_playerY, NbTour - 1).m_token : 0);
+	Replay.m_nbTour = NbTour;
+	Replay.m_scoreX = Match.m_playerX.m_score;
+	Replay.m_scoreY = Match.m_playerY.m_score;
+}//EndReplay()
 
-			SLog += "\n\r\n\r Ce bonus vous a fait PERDRE 8 en score !";
-			Player.m_score -= 8;
+/*!
+* \brief Encode a record
+*
+* Format : "CMIR", version (u8), graine (varint), état du générateur (4 x 2 x u32), taille et difficulté (varint),
+* les 12 tokens/touches des règles, positions des joueurs (varint), carte au format binaire (longueur varint + carte),
+* obstacles (nombre varint + X, Y varint), coups (nombre varint + un octet par coup),
+* puis le résultat : gagnant (u8), coups joués (varint), scores (u32).
+* \param[in] Replay The record
+* \return The encoded record
+*/
+string EncodeReplay(const SReplay & Replay) {
+
+	const SRules & Rules = Replay.m_rules;
+	const char Tokens[12] = { Rules.m_bonusX, Rules.m_bonusY, Rules.m_bonusZ, Rules.m_mouvLeft, Rules.m_mouvTop, Rules.m_mouvBot,
+		Rules.m_mouvRight, Rules.m_caseEmpty, Rules.m_caseObstacle, Rules.m_caseBorder, Rules.m_tokenPlayerX, Rules.m_tokenPlayerY };
+	const string Map = EncodeMapBinary(Replay.m_map);
+	string Out("CMIR");
+
+	Out += char(1);
+	PutVarint(Out, Replay.m_seed);
+	for (unsigned i(0); i < 4; ++i) {
+		PutU32(Out, uint32_t(Replay.m_state[i]));
+		PutU32(Out, uint32_t(Replay.m_state[i] >> 32));
+	}
 
-			return true;
-		}
-		else if (VObstacle[i].m_X == Player.m_X  &&
-			VObstacle[i].m_Y == Player.m_Y + 1 && Movement == CMouvBot) {
+	PutVarint(Out, Rules.m_sizeX);
+	PutVarint(Out, Rules.m_sizeY);
+	PutVarint(Out, Rules.m_difficult);
+	Out.append(Tokens, 12);
 
-			SLog += "\n\r\n\r Ce bonus vous a fait PERDRE 8 en score !";
-			Player.m_score -= 8;
+	PutVarint(Out, Replay.m_playerX.m_X);
+	PutVarint(Out, Replay.m_playerX.m_Y);
+	PutVarint(Out, Replay.m_playerY.m_X);
+	PutVarint(Out, Replay.m_playerY.m_Y);
 
-			return true;
-		}
-		else if (VObstacle[i].m_X == Player.m_X - 1 &&
-			VObstacle[i].m_Y == Player.m_Y  && Movement == CMouvLeft) {
+	PutVarint(Out, Map.size());
+	Out += Map;
 
-			SLog += "\n\r\n\r Ce bonus vous a fait PERDRE 8 en score !";
-			Player.m_score -= 8;
+	PutVarint(Out, Replay.m_obstacles.size());
+	for (const SObstacle & Obstacle : Replay.m_obstacles) {
+		PutVarint(Out, Obstacle.m_X);
+		PutVarint(Out, Obstacle.m_Y);
+	}
 
-			return true;
-		}
+	PutVarint(Out, Replay.m_moves.size());
+	Out += Replay.m_moves;
 
-		else if (VObstacle[i].m_X == Player.m_X + 1 &&
-			VObstacle[i].m_Y == Player.m_Y  && Movement == CMouvRight) {
+	Out += Replay.m_winner;
+	PutVarint(Out, Replay.m_nbTour);
+	PutU32(Out, uint32_t(Replay.m_scoreX));
+	PutU32(Out, uint32_t(Replay.m_scoreY));
 
-			SLog += "\n\r\n\r Ce bonus vous a fait PERDRE 8 en score !";
-			Player.m_score -= 8;
+	return Out;
+}//EncodeReplay()
 
-			return true;
-		}
-	}
-	return false;
-}//IsMovementForbidden()
+/*!
+* \brief Decode a record written by EncodeReplay()
+* \param[in] Content The encoded record
+* \param[out] Replay The record
+* \return False (and SLog filled) if the record is invalid
+*/
+bool DecodeReplay(const string & Content, SReplay & Replay) {
 
- /*!
- * \brief Generate random objects into map
- * \param[in] Map Map where objects will be put on
- * \param[in] Difficulty The game difficulty
- * \param[in] NbObs Number of obstacle to print
- * \param[in] NbBonus Number of bonus to print
- */
+	const unsigned char * Data = reinterpret_cast <const unsigned char *> (Content.data());
+	const unsigned char * End = Data + Content.size();
+	uint64_t Value, Values[7];
+	uint32_t Low, High;
 
-void GenerateStaticObject(CMatrice & Map, unsigned & Difficulty, const unsigned & NbObs = 0, const unsigned & NbBonus = 0) {
+	if (Content.size() < 5 || 0 != Content.compare(0, 4, "CMIR") || 1 != Data[4]) {
+		SLog += "\n\r[!] Ce fichier n'est pas un enregistrement de partie (version 1)";
+		return false;
+	}
+	Data += 5;
 
-	SObstacle TmpObs;
-	SBonus TmpBonus;
-	int RndBX, RndBY;
+	bool IsValid = GetVarint(Data, End, Replay.m_seed);
+	for (unsigned i(0); i < 4 && IsValid; ++i) {
+		IsValid = GetU32(Data, End, Low) && GetU32(Data, End, High);
+		Replay.m_state[i] = (uint64_t(High) << 32) | Low;
+	}
 
-	unsigned Choix;
+	for (unsigned i(0); i < 3 && IsValid; ++i) IsValid = GetVarint(Data, End, Values[i]);
+	if (IsValid && End - Data >= 12) {
+		SRules & Rules = Replay.m_rules;
+		char * Tokens[12] = { &Rules.m_bonusX, &Rules.m_bonusY, &Rules.m_bonusZ, &Rules.m_mouvLeft, &Rules.m_mouvTop, &Rules.m_mouvBot,
+			&Rules.m_mouvRight, &Rules.m_caseEmpty, &Rules.m_caseObstacle, &Rules.m_caseBorder, &Rules.m_tokenPlayerX, &Rules.m_tokenPlayerY };
+
+		Rules.m_sizeX = Values[0];
+		Rules.m_sizeY = Values[1];
+		Rules.m_difficult = Values[2];
+		Rules.m_obstacleDensity = 0;	/* la carte est enregistrée : elle n'est jamais régénérée */
+		Rules.m_bonusDensity = 0;
+		for (unsigned i(0); i < 12; ++i) *Tokens[i] = char(*Data++);
+	}
+	else IsValid = false;
 
-	if (1 == Difficulty) {/*EASY*/
+	for (unsigned i(3); i < 7 && IsValid; ++i) IsValid = GetVarint(Data, End, Values[i]);
+	if (IsValid) {
+		Replay.m_playerX = InitPlayer(1, 1, Values[3], Values[4], Replay.m_rules.m_tokenPlayerX);
+		Replay.m_playerY = InitPlayer(1, 1, Values[5], Values[6], Replay.m_rules.m_tokenPlayerY);
+	}
 
+	IsValid = IsValid && GetVarint(Data, End, Value) && Value <= uint64_t(End - Data)
+		&& DecodeMapBinary(reinterpret_cast <const char *> (Data), Value, Replay.m_map);
+	if (IsValid) Data += Value;
 
-		for (unsigned i(0); i < NbObs; ++i) {
+	IsValid = IsValid && GetVarint(Data, End, Value) && Value <= uint64_t(End - Data);
+	Replay.m_obstacles.clear();
+	for (uint64_t i(0); IsValid && i < Value; ++i) {
+		uint64_t X, Y;
+		IsValid = GetVarint(Data, End, X) && GetVarint(Data, End, Y) && X < Replay.m_map.NbColumn() && Y < Replay.m_map.NbLine();
+		if (IsValid) Replay.m_obstacles.push_back(InitObstacle(X, Y, Replay.m_rules.m_caseObstacle));
+	}
 
-			int MaxX = round((KSizeX / 2)) + Rand(1, 2);
-			int MaxY = round((KSizeY / 2)) - Rand(0, 1);
+	IsValid = IsValid && GetVarint(Data, End, Value) && Value <= uint64_t(End - Data);
+	if (IsValid) {
+		Replay.m_moves.assign(reinterpret_cast <const char *> (Data), Value);
+		Data += Value;
+	}
 
-			int RndX = round(Rand(2, MaxX));
-			int RndY = round(Rand(2, MaxY));
+	IsValid = IsValid && Data < End;
+	if (IsValid) Replay.m_winner = char(*Data++);
+	IsValid = IsValid && GetVarint(Data, End, Value) && GetU32(Data, End, Low) && GetU32(Data, End, High) && Data == End;
+	if (IsValid) {
+		Replay.m_nbTour = Value;
+		Replay.m_scoreX = int(Low);
+		Replay.m_scoreY = int(High);
+	}
 
-			TmpObs = InitObstacle(RndX, RndY, CaseObstacle);
+	/* Les joueurs doivent être à l'intérieur de la carte */
+	IsValid = IsValid && Replay.m_playerX.m_X < Replay.m_map.NbColumn() && Replay.m_playerX.m_Y < Replay.m_map.NbLine()
+		&& Replay.m_playerY.m_X < Replay.m_map.NbColumn() && Replay.m_playerY.m_Y < Replay.m_map.NbLine();
 
-			if ((PlayerX.m_X == TmpObs.m_X && PlayerX.m_Y == TmpObs.m_Y)
-				&& PlayerY.m_X == TmpObs.m_X && PlayerY.m_Y == TmpObs.m_Y) {
+	if (!IsValid) SLog += "\n\r[!] Enregistrement de partie corrompu ou tronqué";
+	return IsValid;
+}//DecodeReplay()
 
-				--i;
-				continue;
-			}
+/*!
+* \brief Write a record into a file (WriteFileAtomic() : an interrupted save leaves the previous file)
+* \param[in] Replay The record
+* \param[in] DestFile The file
+* \return False if the file can't be written
+*/
+bool SaveReplay(const SReplay & Replay, const string & DestFile) {
 
-			else {
-				if (!(IsSurrounded(Map, PlayerX)) || !(IsSurrounded(Map, PlayerY)))
-					GenerateRandomObstacles(Map, TmpObs, Rand(1, 3));
-			}
-		}
+	string Content = EncodeReplay(Replay);
+	vector <struct iovec> Parts(1, { &Content[0], Content.size() });
+	return WriteFileAtomic(DestFile, Parts);
+}//SaveReplay()
 
-		for (unsigned i(0); i < NbBonus; ++i) {
-			Choix = Rand(1, 3);
-			RndBX = Rand(round(KSizeX - round(KSizeX / 3)) - Rand(1, 3), round(KSizeX - round(KSizeX / 5)) + Rand(1, 3));
-			RndBY = Rand(round(KSizeY - round(KSizeY / 3)) - Rand(1, 3), round(KSizeY - round(KSizeY / 5)) + Rand(1, 3));
+/*!
+* \brief Read a record from a file
+* \param[in] File The file
+* \param[out] Replay The record
+* \return False (and SLog filled) if the file can't be read or is invalid
+*/
+bool LoadReplay(const string & File, SReplay & Replay) {
 
-			if (Choix == 1) TmpBonus = InitBonus(RndBX - 1, RndBY, BonusY);
-			else if (Choix == 2) TmpBonus = InitBonus(RndBX - 1, RndBY, BonusX);
-			else if (Choix == 3) TmpBonus = InitBonus(RndBX - 1, RndBY, BonusZ);
+	string Content;
 
-			PutBonus(Map, TmpBonus);
-		}
+	if (!ReadFile(File, Content)) {
+		SLog += "\n\r[!] Impossible de lire l'enregistrement " + File;
+		return false;
 	}
 
-	else if (2 == Difficulty) { /*HARD*/
+	return DecodeReplay(Content, Replay);
+}//LoadReplay()
 
+/*!
+* \brief Put a game back in its recorded state, before the first move
+* \param[out] Match The game
+* \param[out] Map The game map
+* \param[in] Replay The record
+*/
+void RestoreReplayStart(SMatch & Match, CMatrice & Map, const SReplay & Replay) {
 
-		for (unsigned i(0); i < NbObs; ++i) {
+	Map = Replay.m_map;
 
-			unsigned MinX = round((KSizeX / 2)) - Rand(1, 3);
-			unsigned MaxX = round((KSizeX / 2)) + Rand(1, 2);
-			unsigned MinY = round((KSizeY / 2)) - Rand(3, 4);
-			unsigned MaxY = round((KSizeY / 2)) + Rand(2, 3);
+	InitMatch(Match, Replay.m_rules, Replay.m_seed);
+	Match.m_random.SetState(Replay.m_state);
+	Match.m_playerX = Replay.m_playerX;
+	Match.m_playerY = Replay.m_playerY;
 
-			unsigned RndX = round(Rand(MinX, MaxX));
-			unsigned RndY = round(Rand(MinY, MaxY));
+	ResetLayers(Match, Map);
+	for (SObstacle Obstacle : Replay.m_obstacles) {
+		Match.m_obstacleLayer.Insert(Obstacle.m_X, Obstacle.m_Y);
+		Match.m_obstacles.push_back(Obstacle);
+	}
+}//RestoreReplayStart()
 
-			TmpObs = InitObstacle(RndX, RndY, CaseObstacle);
+/*!
+* \brief Play a recorded game again, at full speed or displayed
+*
+* La partie repart de l'état enregistré (carte, obstacles, générateur aléatoire) et rejoue les coups avec MovePlayer() :
+* les bonus tirent les mêmes obstacles, la partie doit donc se terminer comme l'enregistrement.
+* \param[in] Replay The record
+* \param[in] IsShown Display the game or not
+* \param[in] Delay Time between two displayed moves (milliseconds)
+* \return The game result
+*/
+SMatchResult PlayReplay(const SReplay & Replay, const bool IsShown = false, const unsigned Delay = 0) {
 
+	SMatch Match;
+	SMatchResult Result;
+	CMatrice Map;
+	CBoardRenderer Renderer;
 
-			if ((PlayerX.m_X == TmpObs.m_X && PlayerX.m_Y == TmpObs.m_Y)
-				&& PlayerY.m_X == TmpObs.m_X && PlayerY.m_Y == TmpObs.m_Y) {
-				--i;
-				continue;
-			}
+	RestoreReplayStart(Match, Map, Replay);
 
-			else {
-				if (!(IsSurrounded(Map, PlayerX)) || !(IsSurrounded(Map, PlayerY)))
-					GenerateRandomObstacles(Map, TmpObs, Rand(2, 5));
-			}
-		}
+	Result.m_seed = Replay.m_seed;
+	Result.m_winner = 0;
+	Result.m_nbTour = Replay.m_moves.size();
 
+	if (IsShown) ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
 
-		RndBX = Rand(round(KSizeX - round(KSizeX / 3)) - Rand(1, 3), round(KSizeX - round(KSizeX / 5)));
-		RndBY = Rand(round(KSizeY - round(KSizeY / 3)) - Rand(1, 3), round(KSizeY - round(KSizeY / 5)));
+	for (unsigned Tour(0); Tour < Replay.m_moves.size(); ++Tour) {
+		SPlayer & ActualPlayer = (Tour % 2 == 0 ? Match.m_playerX : Match.m_playerY);
 
-		for (unsigned i(0); i < NbBonus; ++i) {
-			Choix = Rand(1, 3);
+		if ('.' != Replay.m_moves[Tour]) MovePlayer(Match, Map, Replay.m_moves[Tour], ActualPlayer);
 
-			if (1 == Choix)  TmpBonus = InitBonus(RndBX - 1, RndBY, BonusY);
-			else if (2 == Choix) TmpBonus = InitBonus(RndBX - 1, RndBY, BonusX);
-			else if (3 == Choix) TmpBonus = InitBonus(RndBX - 1, RndBY, BonusZ);
+		if (IsShown) {
+			Frame.Begin();
+			ShowBoard(Renderer, "solo.title", Map, ActualPlayer, Tour % 2 == 0 ? Match.m_playerY : Match.m_playerX);
+			Couleur(KMagenta);
+			cout << "\r\n[+] Coup " << Tour + 1 << " / " << Replay.m_moves.size() << " : '" << ActualPlayer.m_token << "' -> '"
+				<< Replay.m_moves[Tour] << "'    \r\n";
+			Couleur(KCyan);
+			cout << "[+] Scores : '" << Match.m_playerX.m_token << "' " << Match.m_playerX.m_score << ", '"
+				<< Match.m_playerY.m_token << "' " << Match.m_playerY.m_score << "    \r\n";
+			Couleur(KReset);
+			Frame.End();
+			this_thread::sleep_for(chrono::milliseconds(Delay));
+		}
 
-			PutBonus(Map, TmpBonus);
+		if (CheckIfWin(Match)) {
+			Result.m_winner = GetWinner(Match.m_playerX, Match.m_playerY, Tour).m_token;
+			Result.m_nbTour = Tour + 1;
+			break;
 		}
 	}
-	else cout << '\r' << endl << "[!] Vérifiez vos options, le difficulté doit être comprise entre 1 (facile) et 2 (difficile)" << endl;
 
+	Match.m_log.clear();
+	Result.m_playerX = Match.m_playerX;
+	Result.m_playerY = Match.m_playerY;
+	return Result;
+}//PlayReplay()
 
-}//GenerateStaticObject
+/*!
+* \brief Check that a replayed game ended as recorded
+* \param[in] Replay The record
+* \param[in] Result The replayed game result
+* \return True if winner, number of moves and scores are the same
+*/
+bool IsReplayMatching(const SReplay & Replay, const SMatchResult & Result) {
+	return Replay.m_winner == Result.m_winner && Replay.m_nbTour == Result.m_nbTour
+		&& Replay.m_scoreX == Result.m_playerX.m_score && Replay.m_scoreY == Result.m_playerY.m_score;
+}//IsReplayMatching()
 
-// PLAYERS
+// EDITOR
 
 /*!
-* \brief Check if player got the bonus that make his size up
-* \param[in] Player Player to check
-* \return Return true if the bonus was taken
+* \brief Export matrix into a specific file
+*
+* Les lignes sont écrites directement depuis la matrice (WriteFileAtomic()) : aucune copie de la carte en mémoire.
+* \param[in] Matrice Matrix to export
+* \param[in] DestFile The output file
+* \return False if the file can't be written
 */
 
-bool IsBonusTaken(const SPlayer & Player) {
-	return (1 == Player.m_sizeX ? false : true);
-}//IsBonusTaken()
-
- /*!
- * \brief Initiate values to an empty player
- * \param[in] Largeur Player's width
- * \param[in] Hauteur Player's height
- * \param[in] AxeX Position X of player
- * \param[in] AxeY Position Y of player
- * \param[in] Token player token
- * \return Final player
- */
+bool ExportMatrice(const CMatrice & Matrice, const string & DestFile) {
 
-SPlayer InitPlayer(const unsigned Largeur, const unsigned Hauteur, const unsigned  AxeX, const unsigned  AxeY, const char  Token) {
+	static char NewLine('\n');
+	vector <struct iovec> Parts;
+	Parts.reserve(size_t(Matrice.NbLine()) * 2);
 
-	SPlayer Player;
+	for (unsigned i(0); i < Matrice.NbLine(); ++i) {
+		if (0 != i) Parts.push_back({ &NewLine, 1 });
+		Parts.push_back({ const_cast <char *> (Matrice[i]), Matrice.NbColumn() });
+	}
 
-	Player.m_sizeX = Largeur;
-	Player.m_sizeY = Hauteur;
-	Player.m_X = AxeX;
-	Player.m_Y = AxeY;
-	Player.m_token = Token;
-	/*Constant values below*/
-	Player.m_score = 0;
+	if (WriteFileAtomic(DestFile, Parts)) return true;
 
-	return Player;
-}//InitPlayer()
+	SLog += "\n\r[!] Impossible d'écrire " + DestFile;
+	return false;
+} //ExportMatrice()
 
- /*!
- * \brief Move player to a specific position
- * \param[in] Matrice Game map
- * \param[in] Move Player's movement
- * \param[in] Player Player to move
- */
+/*!
+* \brief Export a chunked matrix into a specific file
+*
+* Les lignes sont écrites par lots, directement depuis les tuiles : une suite de tuiles non allouées est lue dans une seule
+* ligne vide partagée. La mémoire utilisée suit la largeur de la carte et non sa surface.
+* \param[in] Matrice Matrix to export
+* \param[in] DestFile The output file
+* \return False if the file can't be written
+*/
 
-void MovePlayer(CMatrice & Matrice, char Move, SPlayer & Player) {
+bool ExportMatrice(const CChunkedMatrice & Matrice, const string & DestFile) {
 
-	unsigned Additional(0);
-	if (IsMovementForbidden(Player, Move)) return;
-	Player.m_history.push_back(toupper(Move));
-	if (IsBonusTaken(Player)) Additional = 1;
+	static char NewLine('\n');
+	const size_t KBatchSize(4096);	/* buffers par appel à WriteParts() */
+	const unsigned Width = Matrice.NbColumn();
+	string EmptyRow(Width, Matrice.Background());
+	unsigned Line(0);
 
-	if (Move == CMouvTop) {
-		if (Player.m_Y + Player.m_sizeY > 2 + Additional)
-		{
-			--Player.m_Y;
+	const bool IsWritten = WriteFileAtomic(DestFile, [&](vector <struct iovec> & Parts) {
+		for (; Line < Matrice.NbLine() && Parts.size() < KBatchSize; ++Line) {
+			if (0 != Line) Parts.push_back({ &NewLine, 1 });
 
-			GetBonus(Matrice, Player);
-			for (unsigned i(Player.m_X); i < Player.m_X + Player.m_sizeX; ++i) {
-				Matrice[Player.m_Y + Player.m_sizeY][i] = CaseEmpty;
-				Matrice[Player.m_Y][i] = Player.m_token;
+			for (unsigned First(0); First < Width; ) {
+				const unsigned Last = min(Width, (First | (CChunkedMatrice::KTileSize - 1)) + 1);
+				const char * Row = Matrice.FindRow(Line, First);
 
+				if (nullptr != Row) Parts.push_back({ const_cast <char *> (Row), Last - First });
+				/* Tuile vide : on prolonge la dernière part si elle vient déjà de la ligne vide */
+				else if (!Parts.empty() && static_cast <char *> (Parts.back().iov_base) + Parts.back().iov_len == &EmptyRow[0] + First)
+					Parts.back().iov_len += Last - First;
+				else Parts.push_back({ &EmptyRow[First], Last - First });
+				First = Last;
 			}
 		}
-	}
+		return !Parts.empty();
+	});
+	if (IsWritten) return true;
+
+	SLog += "\n\r[!] Impossible d'écrire " + DestFile;
+	return false;
+} //ExportMatrice()
 
+/*!
+* \brief Export matrix into a specific file, in binary format
+* \param[in] Matrice Matrix to export
+* \param[in] DestFile The output file
+* \return False if the file can't be written
+*/
 
-	else if (Move == CMouvBot) {
+bool ExportMatriceBinary(const CMatrice & Matrice, const string & DestFile) {
 
-		if (Player.m_Y + Player.m_sizeY < Matrice.size() - 1) {
-			++Player.m_Y;
-			GetBonus(Matrice, Player);
+	string Binary = EncodeMapBinary(Matrice);
+	vector <struct iovec> Parts(1, { &Binary[0], Binary.size() });
 
-			for (unsigned i(Player.m_X); i < Player.m_X + Player.m_sizeX; ++i) {
-				Matrice[Player.m_Y - 1][i] = CaseEmpty;
-				Matrice[Player.m_Y + Player.m_sizeY - 1][i] = Player.m_token;
+	if (WriteFileAtomic(DestFile, Parts)) return true;
 
-			}
-		}
+	SLog += "\n\r[!] Impossible d'écrire " + DestFile;
+	return false;
+} //ExportMatriceBinary()
+
+/*!
+* \brief Convert a map between text and binary format
+*
+* Le format d'entrée est détecté par sa signature, celui de sortie par l'extension (.cmap : binaire, sinon texte).
+* \param[in] Source The map to convert
+* \param[in] DestFile The output file
+* \return False if the source map can't be loaded
+*/
+
+bool ConvertMap(const string & Source, const string & DestFile) {
+
+	string Content;
+	CMatrice Matrice;
+
+	if (!ReadFile(Source, Content)) {
+		cout << "[!] Impossible de lire " << Source << endl;
+		return false;
 	}
 
-	else if (Move == CMouvLeft) {
-		if (Player.m_X + Player.m_sizeY > 2 + Additional)
-		{
-			--Player.m_X;
-			GetBonus(Matrice, Player);
+	if (!ParseAnyMap(Content, Matrice)) {
+		cout << SLog << endl;
+		SLog.clear();
+		return false;
+	}
 
-			for (unsigned i(Player.m_Y); i < Player.m_Y + Player.m_sizeY; ++i) {
-				Matrice[i][Player.m_X + Player.m_sizeX] = CaseEmpty;
-				Matrice[i][Player.m_X] = Player.m_token;
-			}
-		}
+	const bool IsBinary = DestFile.size() >= 5 && DestFile.compare(DestFile.size() - 5, 5, ".cmap") == 0;
+	if (!(IsBinary ? ExportMatriceBinary(Matrice, DestFile) : ExportMatrice(Matrice, DestFile))) {
+		cout << SLog << endl;
+		SLog.clear();
+		return false;
 	}
 
-	else if (Move == CMouvRight) {
-		if (Player.m_X + Player.m_sizeX < Matrice[0].size() - 1)
-		{
-			++Player.m_X;
-			GetBonus(Matrice, Player);
+	cout << "[+] Fin de l'opération !" << endl;
+	return true;
+} //ConvertMap()
 
-			for (unsigned i(Player.m_Y); i < Player.m_Y + Player.m_sizeY; ++i) {
-				Matrice[i][Player.m_X - 1] = CaseEmpty;
-				Matrice[i][Player.m_X + Player.m_sizeX - 1] = Player.m_token;
+/**
+* \class CMapCatalog
+* \brief Catalogue des cartes du dossier ./map : taille, nombre d'obstacles et de bonus de chaque carte.
+*
+* Le dossier est lu avec opendir()/readdir() et seule la date de modification de chaque carte est lue (fstatat()).
+* Une carte n'est ouverte que quand elle est affichée et que l'index (KMapCatalogFile) ne la connaît pas à cette date et
+* avec ces tokens (les comptes changent avec les tokens des options) : l'index est chargé une fois et réécrit quand une
+* carte a été ouverte.
+*/
+class CMapCatalog {
+public:
+	/* Une carte du dossier */
+	struct SEntry {
+		string m_name;	/*!< nom donné à LoadMapByFile() */
+		string m_file;	/*!< fichier lu par LoadMapByFile() (.cmap avant .map) */
+		int64_t m_mtime;	/*!< date de modification (ns) */
+		bool m_isKnown;	/*!< taille et comptes à jour */
+		bool m_isBroken;	/*!< carte illisible (pas relue, pas listée) */
+		unsigned m_nbLine;
+		unsigned m_nbColumn;
+		size_t m_nbObstacle;
+		size_t m_nbBonus;
+		uint64_t m_tokens;	/*!< tokens avec lesquels les comptes ont été faits (TokenKey()) */
+	};
+
+	CMapCatalog() : m_IsIndexLoaded(false), m_IsIndexChanged(false) {}
+
+	/*!
+	* \brief List the maps of the directory, sorted by name
+	* \param[in] Dir The directory
+	* \return False if the directory can't be read
+	*/
+	bool Scan(const string & Dir) {
+		if (!m_IsIndexLoaded) LoadIndex();
+		m_Entries.clear();
+
+		DIR * Directory = opendir(Dir.c_str());
+		if (nullptr == Directory) return false;
+
+		const string Prefix("MyMap_");
+		map <string, SEntry> Found;
+
+		for (const dirent * File = readdir(Directory); nullptr != File; File = readdir(Directory)) {
+			const string FileName(File->d_name);
+			const bool IsBinary = EndsWith(FileName, ".cmap");
+			if (0 != FileName.compare(0, Prefix.size(), Prefix) || !(IsBinary || EndsWith(FileName, ".map"))) continue;
+
+			struct stat Stat;
+			if (0 != fstatat(dirfd(Directory), File->d_name, &Stat, 0) || !S_ISREG(Stat.st_mode)) continue;
+
+			const string Name = FileName.substr(Prefix.size(), FileName.size() - Prefix.size() - (IsBinary ? 5 : 4));
+			if (Found.count(Name) && !IsBinary) continue;	/* LoadMapByFile() préfère le .cmap */
+
+			SEntry Entry;
+			Entry.m_name = Name;
+			Entry.m_file = Dir + '/' + FileName;
+			Entry.m_mtime = int64_t(Stat.st_mtim.tv_sec) * 1000000000 + Stat.st_mtim.tv_nsec;
+			Entry.m_isKnown = false;
+			Entry.m_isBroken = false;
+
+			const auto Known = m_Index.find(Entry.m_file);
+			if (Known != m_Index.end() && Known->second.m_mtime == Entry.m_mtime) {
+				Entry = Known->second;
+				Entry.m_name = Name;	/* l'index ne garde que le fichier */
 			}
+			Found[Name] = Entry;
 		}
-	}
-}//MovePlayer()
-
- /*!
- * \brief Move player to the position depending of what he typed
- * \param[in] ch Entered key
- * \param[in] Map Game's map
- * \param[in] Player Player to move
- */
+		closedir(Directory);
 
-void KeyEvent(const int & ch, CMatrice & Map, SPlayer & Player) {
+		m_Entries.reserve(Found.size());
+		for (const auto & Entry : Found) m_Entries.push_back(Entry.second);
 
-	if (ch == CMouvTop)
-		MovePlayer(Map, CMouvTop, Player);
-	else if (ch == CMouvBot)
-		MovePlayer(Map, CMouvBot, Player);
-	else if (ch == CMouvLeft)
-		MovePlayer(Map, CMouvLeft, Player);
-	else if (ch == CMouvRight)
-		MovePlayer(Map, CMouvRight, Player);
-	else if (ch == char(3)/*CTRL+C*/) {
-		cout << endl;
-		endwin();
-		exit(0);
-	}
-	else if (ch == 'r'/*RESTART*/) {
-		cout << endl;
-		endwin();
-		system("rm main.out 2>/dev/null; g++ -std=c++11  main.cpp -o main.out -Wall -ltinfo -lncurses; ./main.out");
-		exit(0);
+		/* Les cartes supprimées sortent de l'index */
+		map <string, SEntry> Index;
+		for (const SEntry & Entry : m_Entries) {
+			const auto Known = m_Index.find(Entry.m_file);
+			if (Known != m_Index.end()) Index.insert(*Known);
+		}
+		m_IsIndexChanged = m_IsIndexChanged || Index.size() != m_Index.size();
+		m_Index.swap(Index);
+		return true;
 	}
 
+	size_t Size() const { return m_Entries.size(); }
+	const string & Name(const size_t Index) const { return m_Entries[Index].m_name; }
 
-}//KeyEvent()
-
-// IA (BOT)
+	/*!
+	* \brief Get a map of the last Scan(), opening it if the index doesn't know it
+	* \param[in] Rules Rules giving the obstacle and bonus tokens
+	* \param[in] Index Index of the map (sorted by name)
+	* \return The map entry (m_isBroken true if it can't be loaded)
+	*/
+	const SEntry & Get(const SRules & Rules, const size_t Index) {
+		SEntry & Entry = m_Entries[Index];
+		if (Entry.m_isBroken || (Entry.m_isKnown && TokenKey(Rules) == Entry.m_tokens)) return Entry;
+
+		string Content;
+		CMatrice Map;
+		if (!ReadFile(Entry.m_file, Content) || !ParseAnyMap(Content, Map)) {
+			Entry.m_isBroken = true;
+			return Entry;
+		}
 
-/*!
-* \brief Move bot to a specific position
-* \param[in] ch Entered key
-* \param[in] Map Game map
-* \param[in] Tour Actual round
-*/
-void MoveBot(int & ch, CMatrice & Map, const unsigned & Tour) {
+		const SMapScan Scan = ScanMap(Rules, Map);
+		Entry.m_nbLine = Map.NbLine();
+		Entry.m_nbColumn = Map.NbColumn();
+		Entry.m_nbObstacle = Scan.m_nbObstacle;
+		Entry.m_nbBonus = Scan.m_nbBonus;
+		Entry.m_tokens = TokenKey(Rules);
+		Entry.m_isKnown = true;
+
+		m_Index[Entry.m_file] = Entry;
+		m_IsIndexChanged = true;
+		return Entry;
+	}
 
+	/*!
+	* \brief Write the index if a map was opened since it was loaded
+	* \param[in] File The index file
+	* \return False if the index can't be written
+	*/
+	bool SaveIndex(const string & File = KMapCatalogFile) {
+		if (!m_IsIndexChanged) return true;
+
+		/* Une ligne par carte : date taille obstacles bonus tokens fichier */
+		string Content;
+		for (const auto & Known : m_Index) {
+			const SEntry & Entry = Known.second;
+			Content += to_string(Entry.m_mtime) + ' ' + to_string(Entry.m_nbLine) + ' ' + to_string(Entry.m_nbColumn) + ' '
+				+ to_string(Entry.m_nbObstacle) + ' ' + to_string(Entry.m_nbBonus) + ' ' + to_string(Entry.m_tokens) + ' ' + Entry.m_file + '\n';
+		}
 
-	if (1 == Tour % 2 && (!(PlayerX.m_X == PlayerY.m_X))) {
-		if (PlayerY.m_X - 1 < PlayerX.m_X) MovePlayer(Map, CMouvRight, PlayerY);
-		else MovePlayer(Map, CMouvLeft, PlayerY);
+		vector <struct iovec> Parts(1, { &Content[0], Content.size() });
+		m_IsIndexChanged = !WriteFileAtomic(File, Parts);
+		return !m_IsIndexChanged;
 	}
 
-	else {
-		if (!(PlayerX.m_Y == PlayerY.m_Y)) {
-			if ((PlayerY.m_Y - 1) < PlayerX.m_Y) MovePlayer(Map, CMouvBot, PlayerY);
-			else MovePlayer(Map, CMouvTop, PlayerY);
-		}
+private:
+	static bool EndsWith(const string & Str, const string & End) {
+		return Str.size() >= End.size() && 0 == Str.compare(Str.size() - End.size(), End.size(), End);
 	}
 
-}//MoveBot()
+	/* Les 8 tokens classés par ScanMap(), un octet chacun */
+	static uint64_t TokenKey(const SRules & Rules) {
+		const char Tokens[8] = { Rules.m_caseObstacle, Rules.m_caseBorder, Rules.m_bonusX, Rules.m_bonusY, Rules.m_bonusZ,
+			Rules.m_caseEmpty, Rules.m_tokenPlayerX, Rules.m_tokenPlayerY };
+		uint64_t Key(0);
+		for (const char Token : Tokens) Key = (Key << 8) | uint8_t(Token);
+		return Key;
+	}
 
-// EDITOR
+	void LoadIndex(const string & File = KMapCatalogFile) {
+		string Content;
+		m_IsIndexLoaded = true;
+		if (!ReadFile(File, Content)) return;
+
+		for (size_t Begin(0), End; Begin < Content.size(); Begin = End + 1) {
+			End = Content.find('\n', Begin);
+			if (string::npos == End) End = Content.size();
+
+			const char * Pos = Content.c_str() + Begin;
+			char * Next;
+			uint64_t Values[6];
+			bool IsValid(true);
+
+			/* Un index d'avant les tokens (5 valeurs) est ignoré : ses cartes sont recomptées */
+			for (unsigned i(0); i < 6 && IsValid; ++i) {
+				Values[i] = strtoull(Pos, &Next, 10);
+				IsValid = (Next != Pos && ' ' == *Next);
+				Pos = Next + 1;
+			}
+			if (!IsValid || Pos >= Content.c_str() + End) continue;
+
+			SEntry Entry;
+			Entry.m_file.assign(Pos, Content.c_str() + End);
+			Entry.m_mtime = int64_t(Values[0]);
+			Entry.m_nbLine = unsigned(Values[1]);
+			Entry.m_nbColumn = unsigned(Values[2]);
+			Entry.m_nbObstacle = Values[3];
+			Entry.m_nbBonus = Values[4];
+			Entry.m_tokens = Values[5];
+			Entry.m_isKnown = true;
+			Entry.m_isBroken = false;
+			m_Index[Entry.m_file] = Entry;
+		}
+	}
 
-/*!
-* \brief Export matrix into a specific file
-* \param[in] Matrice Matrix to export
-* \param[in] DestFile The output file
-*/
+	bool m_IsIndexLoaded;
+	bool m_IsIndexChanged;
+	map <string, SEntry> m_Index;	/*!< fichier -> carte connue */
+	vector <SEntry> m_Entries;
+}; //CMapCatalog
 
-void ExportMatrice(CMatrice & Matrice, const string & DestFile) {
+CMapCatalog MapCatalog;	/*!< maps of KMapDir */
 
-	string StrMatrice;
-	for (unsigned i(0); i < Matrice.size(); ++i) {
-		for (unsigned a(0); a < Matrice[i].size(); ++a) {
+/*!
+* \brief Display a page of the map catalog (the maps of the page not in the index are opened)
+* \param[in] Page The page (KMapPageSize maps per page)
+*/
 
-			StrMatrice += Matrice[i][a];
+void ShowMapPage(const unsigned Page) {
 
-		}
-		if (i < Matrice.size() - 1)
-			StrMatrice += '\n';
-	}
+	const SRules Rules = GetRules();
+	const size_t First = size_t(Page) * KMapPageSize;
 
-	ofstream ofs(DestFile);
-	if (ofs.is_open()) {
+	Couleur(KCyan);
+	cout << "\n\r[+] Cartes " << First + 1 << " à " << min(First + KMapPageSize, MapCatalog.Size()) << " sur " << MapCatalog.Size()
+		<< " (page " << Page + 1 << '/' << (MapCatalog.Size() + KMapPageSize - 1) / KMapPageSize << ") :\n\r";
+	Couleur(KReset);
 
-		ofs << StrMatrice;
-		ofs.close();
+	for (size_t i(First); i < First + KMapPageSize && i < MapCatalog.Size(); ++i) {
+		const CMapCatalog::SEntry & Entry = MapCatalog.Get(Rules, i);
+		if (Entry.m_isBroken) continue;	/* carte illisible : sautée */
+
+		cout << "\n\r ";
+		Couleur(KRouge);
+		cout << "[" << i + 1 << "] ";
+		Couleur(KReset);
+		cout << Entry.m_name << " : " << Entry.m_nbColumn << 'x' << Entry.m_nbLine << ", " << Entry.m_nbObstacle << " obstacle(s), " << Entry.m_nbBonus << " bonus";
 	}
-	else cout << "[!] Impossible d'écrire ici...\n\r";
-	cout << "[+] Fin de l'opération !";
-} //ExportMatrice()
+	cout << "\n\r";
+
+	MapCatalog.SaveIndex();
+} //ShowMapPage()
 
 /*!
-* \brief Ask the player for map name
-* \return Output path
+* \brief Ask the player for a map : its number in the catalog or its name
+* \return The map name (given to LoadMapByFile())
 */
 
 string AskForMap() {
 
-	string MapName;
+	string Answer;
+	unsigned Page(0);
 
-	cout << "\n\r[?] Quel est le nom de votre carte (Nom : mot comprit entre 'Mymap_' et '.map')? : ";
-	Couleur(KReset);
-	cin >> MapName;
+	if (!MapCatalog.Scan(KMapDir)) SLog += "\n\r[!] Impossible de lire le dossier " + KMapDir;
+
+	for (;;) {
+		if (0 != MapCatalog.Size()) ShowMapPage(Page);
+
+		Couleur(KRouge);
+		cout << "\n\r[?] Numéro ou nom de votre carte (Nom : mot compris entre 'MyMap_' et '.map', + / - : page suivante / précédente) : ";
+		Couleur(KReset);
+		if (!(cin >> Answer)) return Answer;
+
+		if ("+" == Answer) {
+			if (size_t(Page + 1) * KMapPageSize < MapCatalog.Size()) ++Page;
+			continue;
+		}
+		if ("-" == Answer) {
+			if (0 != Page) --Page;
+			continue;
+		}
 
-	return MapName;
+		/* Un numéro de la liste, sinon un nom de carte */
+		if (string::npos == Answer.find_first_not_of("0123456789") && Answer.size() < 10) {
+			const size_t Number = stoul(Answer);
+			if (Number >= 1 && Number <= MapCatalog.Size()) return MapCatalog.Name(Number - 1);
+		}
+		return Answer;
+	}
 } //AskForMap()
 
 /*!
@@ -1139,7 +4570,8 @@ recheck:
 
 		Couleur(KReset);
 		PrintLines(1);
-		system("ls ./map");
+		if (MapCatalog.Scan(KMapDir) && 0 != MapCatalog.Size()) ShowMapPage(0);
+		else cout << "\n\r[!] Aucune carte dans " << KMapDir << "\n\r";
 		PrintLines(1);
 		goto recheck;
 	}
@@ -1149,100 +4581,164 @@ recheck:
 } //isPersoMapRecquiered
 
 /*!
-* \brief Detect obstacle for public map
+* \brief Detect obstacle for public map and check its tokens (single pass, ScanMap())
+* \param[in] Match The game
 * \param[in] Map Game's map
+* \return False if the map holds a token unknown to the rules
 */
 
-void DetectObstacle(CMatrice & Map) {
+bool DetectObstacle(SMatch & Match, CMatrice & Map) {
 
-	SObstacle TmpObstacle;
+	const SMapScan Scan = ResetLayers(Match, Map, true);
 
-	for (unsigned i(0); i < Map.size(); ++i) {
-		for (unsigned a(0); a < Map[i].size(); ++a) {
-			if (Map[i][a] == CaseObstacle) {
-				TmpObstacle = InitObstacle(i, a, 'e');
-				VObstacle.push_back(TmpObstacle);
-			}
-		}
-	}
+	Match.m_obstacles.reserve(Scan.m_nbObstacle);
+	Match.m_obstacleLayer.ForEachCase([&](const unsigned X, const unsigned Y) {
+		Match.m_obstacles.push_back(InitObstacle(X, Y, Match.m_rules.m_caseObstacle));
+	});
+
+	if (0 == Scan.m_nbUnknown) return true;
 
+	Match.m_log += "\n\r[!] Carte invalide : " + to_string(Scan.m_nbUnknown) + " case(s) inconnue(s), la première en ("
+		+ to_string(Scan.m_unknownX) + ", " + to_string(Scan.m_unknownY) + ") : '" + Map[Scan.m_unknownY][Scan.m_unknownX] + "'.";
+	return false;
 } //DetectObstacle()
 
 
 // DISPLAYS
 
 /*!
-* \brief Display multiplayer game
+* \brief Save the replay of the game played in the console into KReplayFile
+* \param[in] Replay The game record
+* \param[in] NbTour Number of moves played
 */
 
-void DisplayMulti() {
+void SaveGameReplay(SReplay & Replay, const unsigned NbTour) {
+	EndReplay(Replay, Game, NbTour);
 
-	unsigned Nbround = GetTourMax();
-	int ch;
-	CMatrice Map;
-
-	PlayerX = InitPlayer(1, 1, 1, 1, TokenPlayerX);
+	Couleur(KCyan);
+	if (SaveReplay(Replay, KReplayFile)) cout << "\r\n[+] Partie enregistrée dans " << KReplayFile << "\r\n";
+	else cout << "\r\n[!] Impossible d'enregistrer la partie dans " << KReplayFile << "\r\n";
+	Couleur(KReset);
+}//SaveGameReplay()
 
+/*!
+* \brief Restart the game in place, without leaving the program
+*
+* Avec la même graine, la partie repart de son état enregistré au premier coup : même carte, mêmes obstacles, mêmes bonus.
+* Sinon la partie reprend avec une nouvelle graine (KSeed si elle est fixée) : une carte générée est régénérée,
+* une carte chargée depuis un fichier est reprise telle qu'au départ. Le log est vidé.
+* \param[in, out] Match The game
+* \param[in, out] Map The game map
+* \param[in, out] Replay The record of the game, started again
+* \param[in] IsSameSeed Play the same board again
+* \param[in] IsLoadedMap The map was loaded from a file
+*/
+void RestartMatch(SMatch & Match, CMatrice & Map, SReplay & Replay, const bool IsSameSeed, const bool IsLoadedMap) {
 
-	if (IsPersoMapRecquiered()) {
-		Map = LoadMapByFile(AskForMap());
-		DetectObstacle(Map);
-		PlayerY = InitPlayer(1, 1, KSizeX - 2, KSizeY - 2, TokenPlayerY);
+	if (IsSameSeed)
+		RestoreReplayStart(Match, Map, Replay);
 
+	else if (IsLoadedMap) {
+		InitMatch(Match, Replay.m_rules, KSeed);
+		Map = Replay.m_map;
+		Match.m_playerX = Replay.m_playerX;
+		Match.m_playerY = Replay.m_playerY;
+		DetectObstacle(Match, Map);
 	}
 
 	else {
-		Map = InitMatrice(KSizeX + 1, KSizeY + 1, PlayerX, PlayerY); /* +1 due à la bordure de '#' le long de la Matrice */
+		InitMatch(Match, Replay.m_rules, KSeed);
+		Map = GenerateGameMap(Match);
+	}
 
-		if (KDifficult == 1)
-			GenerateStaticObject(Map, KDifficult, 6, 5);
-		else if (KDifficult == 2)
-			GenerateStaticObject(Map, KDifficult, Rand(7, 9), 4);
+	Match.m_log.clear();
+	StartReplay(Replay, Match, Map);
+}//RestartMatch()
 
-		PlayerY = InitPlayer(1, 1, KSizeX - 1, KSizeY - 1, TokenPlayerY);
+/*!
+* \brief Display multiplayer game
+* \return The next screen
+*/
 
-	}
+EScreen DisplayMulti() {
 
-	InitCurses();
-	ShowMatrice(Map, false);
+	unsigned Nbround = GetTourMax();
+	InitMatch(Game, GetRules(), KSeed);
+	int ch(0);
+	CMatrice Map;
+	SReplay Replay;
 
-	for (unsigned i(0); i < Nbround * 2; ++i) {
+	PlayerX = InitPlayer(1, 1, 1, 1, TokenPlayerX);
 
-		SPlayer &actualPlayer = (i % 2 == 0 ? PlayerX : PlayerY);
+	const bool IsPublicMap = IsPersoMapRecquiered();
+	if (IsPublicMap) {
+		Map = LoadMapByFile(AskForMap());
+		if (Map.Empty()) return KScreenMenu;
+		PlayerY = InitPlayer(1, 1, KSizeX - 2, KSizeY - 2, TokenPlayerY);
+		if (!DetectObstacle(Game, Map)) return KScreenMenu;
+	}
 
-		ShowTitle("multi.title");
-		ShowMatrice(Map, false);
-		ListenKeyboard();
+	else Map = GenerateGameMap(Game);
 
-		DisplayInfos(actualPlayer);
+	CBoardRenderer Renderer;
+	CEventLoop Loop;
+	StartReplay(Replay, Game, Map);
+	Loop.Start();
 
-		Couleur(KMagenta);
-		cout << endl << "[?] Au Tour du joueur '"; Couleur(KBleu); cout << actualPlayer.m_token << '\'' << endl << '\r';
-		Couleur(KReset);
+	while (Replay.m_moves.size() < Nbround * 2) {
 
-		if (0 != i) ch = getch();
+		SPlayer &actualPlayer = (Replay.m_moves.size() % 2 == 0 ? PlayerX : PlayerY);
 
-		KeyEvent(ch, Map, actualPlayer);
+		if (CEventLoop::KEventFrame == Loop.Wait(ch)) {
+			Frame.Begin();
+			ShowBoard(Renderer, "multi.title", Map, actualPlayer, &actualPlayer == &PlayerX ? PlayerY : PlayerX);
+			DisplayInfos(actualPlayer);
 
-		if (CheckIfWin(PlayerX, PlayerY)) {
-			DisplayWin(i);
-			return;
+			Couleur(KMagenta);
+			cout << endl << "[?] Au Tour du joueur '"; Couleur(KBleu); cout << actualPlayer.m_token << '\'' << endl << '\r';
+			Couleur(KReset);
+			Frame.End();
+			continue;
 		}
 
-		refresh();
-		endwin();
+		if (KEY_RESIZE == ch) Renderer.Invalidate();
+		if (KKeyMinimap == ch) Renderer.ToggleMinimap();
 
-		Couleur(KBleu, KHJaune);
-		ClearScreen();
-		SetTextMiddle();
-		PrintLines(16);
+		if (KKeyRestart == ch || KKeyRetry == ch) {
+			RestartMatch(Game, Map, Replay, KKeyRetry == ch, IsPublicMap);
+			Renderer.Invalidate();
+			Loop.Invalidate();
+			continue;
+		}
 
-		cout << "[!] Egalité !" << endl;
-		Couleur(KReset);
+		KeyEvent(ch, Map, actualPlayer);
+		Loop.Invalidate();
+		if (!IsMoveKey(Game.m_rules, ch)) continue;	/* seules les touches de déplacement terminent le tour */
 
-		endwin();
+		RecordMove(Replay, Game.m_rules, &actualPlayer == &PlayerX, ch);
 
+		if (CheckIfWin(Game)) {
+			Loop.Stop();
+			DisplayWin(Replay.m_moves.size() - 1);
+			SaveGameReplay(Replay, Replay.m_moves.size());
+			WaitForEnter();
+			return KScreenMenu;
+		}
 	}
+
+	Loop.Stop();
+
+	Couleur(KBleu, KHJaune);
+	ClearScreen();
+	SetTextMiddle();
+	PrintLines(16);
+
+	cout << "[!] Egalité !" << endl;
+	Couleur(KReset);
+	SaveGameReplay(Replay, Replay.m_moves.size());
+	WaitForEnter();
+
+	return KScreenMenu;
 }//DisplayMulti()
 
  /*!
@@ -1266,6 +4762,7 @@ void DisplayLog() {
 void DisplayInfos(const SPlayer & Player) {
 	Couleur(KVert);
 	cout << endl << "[+] Difficulté : " << KDifficult << flush << endl << '\r';
+	cout << "[+] Graine : " << Game.m_random.GetSeed() << endl << '\r';
 
 	Couleur(KCyan);
 	cout << endl << "[+] Taille : (" << KSizeX << ", " << KSizeY << ')' << endl << '\r';
@@ -1284,8 +4781,12 @@ void DisplayInfos(const SPlayer & Player) {
 	Couleur(KJaune);
 
 	cout << endl << "[!] Attention :" << endl << '\r' << "Si vous êtes bloqués, veuillez appuyer sur la touche "; Couleur(KRouge, KHVert);
-	cout << 'R'; Couleur(KReset); Couleur(KJaune);
-	cout << " (restart)" << endl << '\r';
+	cout << KKeyRestart; Couleur(KReset); Couleur(KJaune);
+	cout << " (nouvelle carte) ou "; Couleur(KRouge, KHVert);
+	cout << KKeyRetry; Couleur(KReset); Couleur(KJaune);
+	cout << " (même carte)" << endl << '\r';
+	cout << "La touche "; Couleur(KRouge, KHVert); cout << KKeyMinimap; Couleur(KReset); Couleur(KJaune);
+	cout << " affiche toute la carte en réduit (minimap)" << endl << '\r';
 
 	Couleur(KCyan); cout << endl << "[+] Votre score est de : " << Player.m_score << endl << '\r'; Couleur(KReset);
 
@@ -1294,48 +4795,50 @@ void DisplayInfos(const SPlayer & Player) {
 
 /*!
 * \brief Display game's options
+* \return The next screen
 */
 
-void DisplayOption() {
+EScreen DisplayOption() {
 
 	ClearScreen();
 	ShowTitle("option.title");
 
-	cout << endl << endl << "Liste des options par defaut : " << endl << endl;
-	for (unsigned i(0); i < VOptionsName.size(); ++i) cout << i << ". " << VOptionsName[i] << " : '" << VOptionValue[i] << '\'' << endl;
+	cout << endl << endl << "Liste des options : " << endl << endl;
+	for (unsigned i(0); i < KNbOption; ++i) cout << i << ". " << KOptions[i].m_name << " : '" << GetOptionValue(KOptions[i]) << '\'' << endl;
 
 	Couleur(KRouge);
-	cout << endl << "[!] Attention, ces configurations ne seront présentes jusqu'à la fermeture complète du jeu." << endl;
+	cout << endl << "[!] Les options modifiées sont enregistrées dans " << KOptionFile << " et rechargées au lancement du jeu." << endl;
 
 	unsigned Numero;
 	string NewParam;
 
 	Couleur(KCyan);
 	cout << endl << "[+] Afin de modifier un paramètre, veuillez entrer le numéro correspondant : ";
-	cin >> Numero;
-
-	if (Numero > VOptionsName.size()) {
+	if (!(cin >> Numero) || Numero >= KNbOption) {
+		if (cin.eof()) return KScreenQuit;
+		cin.clear();
+		cin.ignore(numeric_limits<streamsize>::max(), '\n');
 		SLog += "Vous avez été renvoyé au menu car le paramétre ne correspondait à aucune valeur.";
-		DisplayMenu();
-		return;
+		Couleur(KReset);
+		return KScreenMenu;
 	}
 
-	cout << VOptionsName[Numero] << " deviendra : ";
+	cout << KOptions[Numero].m_name << " deviendra : ";
 	cin >> NewParam;
-	SetConfig(VOptionsName[Numero], NewParam);
+	if (SetConfig(KOptions[Numero].m_name, NewParam) && !SaveOption(KOptions[Numero].m_name))
+		SLog += "\n\r[!] Impossible d'enregistrer les options dans " + KOptionFile;
 
 	Couleur(KReset);
 
-	DisplayMenu();
-
-	Couleur(KReset);
+	return KScreenMenu;
 }//DisplayOption()
 
 /*!
 * \brief Display game's meny
+* \return The chosen screen
 */
 
-void DisplayMenu() {
+EScreen DisplayMenu() {
 
 	unsigned Choice(0);
 
@@ -1360,44 +4863,45 @@ void DisplayMenu() {
 	DisplayLog();
 	cout << endl << "[?] Choissisez entre [1-" << menulist.size() << "] : ";
 
-	unsigned input;
-	cin >> input;
+	unsigned input(0);
+	if (!(cin >> input)) {
+		if (cin.eof()) return KScreenQuit;
+		cin.clear();
+		cin.ignore(numeric_limits<streamsize>::max(), '\n');
+	}
 
 	switch (input) {
 	case 1:
-		DisplaySoloIA();
-		break;
+		return KScreenSolo;
 	case 2:
-		DisplayMulti();
-		break;
+		return KScreenMulti;
 	case 3:
-		DisplayEditor();
-		break;
+		return KScreenEditor;
 	case 4:
-		DisplayOption();
-		break;
+		return KScreenOption;
 	case 5:
-		exit(0);
+		return KScreenQuit;
 
 	default:
-
-		Couleur(KRouge, KHCyan);
-		cout << endl << "[!] Choix invalide !" << endl;
-		Couleur(KReset);
+		SLog += "Choix invalide !";
+		return KScreenMenu;
 	}
 } //DisplayMenu()
 
 /*!
 * \brief Display game agaisn't bot (IA)
+* \return The next screen
 */
 
-void DisplaySoloIA() {
+EScreen DisplaySoloIA() {
 
 	unsigned Nbround = GetTourMax();
+	InitMatch(Game, GetRules(), KSeed);
 	bool IsPublicMap = IsPersoMapRecquiered();
-	int Key;
+	int Key(0);
 	CMatrice Map;
-	unsigned TourIA, Tour(0);
+	SReplay Replay;
+	unsigned TourIA(0);
 
 	PlayerX = InitPlayer(1, 1, 1, 1, TokenPlayerX);
 
@@ -1405,80 +4909,96 @@ void DisplaySoloIA() {
 
 		PlayerY = InitPlayer(1, 1, KSizeX - 2, KSizeY - 2, TokenPlayerY);
 		Map = LoadMapByFile(AskForMap());
-		DetectObstacle(Map);
-	}
-
-	else {
-
-		PlayerY = InitPlayer(1, 1, KSizeX - 1, KSizeY - 1, TokenPlayerY);
-		Map = InitMatrice(KSizeX + 1, KSizeY + 1, PlayerX, PlayerY); /* +1 due à la bordure de '#' le long de la Matrice */
-
-		if (KDifficult == 1)
-			GenerateStaticObject(Map, KDifficult, 6, 5);
-		else
-			GenerateStaticObject(Map, KDifficult, Rand(7, 9), 4);
+		if (Map.Empty()) return KScreenMenu;
+		if (!DetectObstacle(Game, Map)) return KScreenMenu;
 	}
 
-	InitCurses();
-
-	SetTextMiddle();
-	ShowMatrice(Map);
+	else Map = GenerateGameMap(Game);
 
-	for (; Tour < Nbround * 2; ++Tour) {
-		/*PlayerX = User. PlayerY = IA.*/
-		SPlayer &actualPlayer = (Tour % 2 == 0 ? PlayerX : PlayerY);
+	CBoardRenderer Renderer;
+	CEventLoop Loop;
+	StartReplay(Replay, Game, Map);
+	Loop.Start(BRealTime ? KBotDelay : 0);
 
-		PrintLines(1);
-		ShowTitle("solo.title");
+	/*PlayerX = User. PlayerY = IA.*/
+	while (Replay.m_moves.size() < Nbround * 2) {
 
-		ShowMatrice(Map, false);
+		const int Event = Loop.Wait(Key);
 
-		ListenKeyboard();
+		if (CEventLoop::KEventFrame == Event) {
+			Frame.Begin();
+			ShowBoard(Renderer, "solo.title", Map, PlayerX, PlayerY);
+			DisplayInfos(PlayerX);
 
-		DisplayInfos(PlayerX);
+			Couleur(KMagenta);
+			cout << endl << "[+] A vous de jouer '"; Couleur(KBleu); cout << PlayerX.m_token << "' !" << endl << '\r';
+			Couleur(KReset);
+			Frame.End();
+			continue;
+		}
 
-		Couleur(KMagenta);
-		cout << endl << "[+] A vous de jouer '"; Couleur(KBleu); cout << PlayerX.m_token << "' !" << endl << '\r';
-		Couleur(KReset);
+		if (CEventLoop::KEventKey == Event) {
+			if (KEY_RESIZE == Key) Renderer.Invalidate();
+			if (KKeyMinimap == Key) Renderer.ToggleMinimap();
 
-		if (!(Tour % 2 == 0))
-			Key = getch();
+			if (KKeyRestart == Key || KKeyRetry == Key) {
+				RestartMatch(Game, Map, Replay, KKeyRetry == Key, IsPublicMap);
+				TourIA = 0;
+				Renderer.Invalidate();
+				Loop.Invalidate();
+				continue;
+			}
 
-		if (actualPlayer.m_token == PlayerX.m_token)
 			KeyEvent(Key, Map, PlayerX);
+			Loop.Invalidate();
+			if (!IsMoveKey(Game.m_rules, Key)) continue;	/* seules les touches de déplacement terminent le tour */
 
-		else if (actualPlayer.m_token == PlayerY.m_token) {
-			MoveBot(Key, Map, TourIA);
-			++TourIA;
-		}
+			RecordMove(Replay, Game.m_rules, true, Key);
 
-		if (CheckIfWin(PlayerX, PlayerY)) {
-			DisplayWin(Tour, false);
-			return;
+			if (CheckIfWin(Game)) break;
+			if (BRealTime) continue;	/* en temps réel, le bot joue à son propre rythme */
 		}
 
-		refresh();
-		endwin();
+		/* Tick du bot, ou sa réponse au coup du joueur */
+		if (Replay.m_moves.size() >= Nbround * 2) break;
+		RecordMove(Replay, Game.m_rules, false, MoveBot(Game, Map, TourIA));
+		++TourIA;
+		Loop.Invalidate();
 
-		Couleur(KBleu, KHJaune);
-		ClearScreen();
-		SetTextMiddle();
-		PrintLines(16);
-		cout << "[!] Egalité !" << endl;
-		Couleur(KReset);
+		if (CheckIfWin(Game)) break;
+	}
 
-		endwin();
+	Loop.Stop();
 
+	if (CheckIfWin(Game)) {
+		DisplayWin(Replay.m_moves.size() - 1, false);
+		SaveGameReplay(Replay, Replay.m_moves.size());
+		WaitForEnter();
+		return KScreenMenu;
 	}
+
+	Couleur(KBleu, KHJaune);
+	ClearScreen();
+	SetTextMiddle();
+	PrintLines(16);
+	cout << "[!] Egalité !" << endl;
+	Couleur(KReset);
+	SaveGameReplay(Replay, Replay.m_moves.size());
+	WaitForEnter();
+
+	return KScreenMenu;
 } //DisplaySoloIA()
 
 /*!
 * \brief Display game's map editor
+*
+* La carte éditée est une CChunkedMatrice : seules les tuiles où quelque chose est posé (bordure, joueurs, obstacles,
+* bonus) occupent de la mémoire, quelle que soit la taille de la carte.
+* \return The next screen
 */
 
-void DisplayEditor() {
-	int Key;
-	bool IsFirstTime = true;
+EScreen DisplayEditor() {
+	int Key(0);
 	unsigned NbLine, NbColumn;
 
 	ShowTitle("editor.title");
@@ -1489,125 +5009,600 @@ void DisplayEditor() {
 	cin >> NbLine;
 	cout << "Taille en largeur : ";
 	cin >> NbColumn;
+	Couleur(KReset);
+
+	if (!cin) {
+		if (cin.eof()) return KScreenQuit;
+		cin.clear();
+		cin.ignore(numeric_limits<streamsize>::max(), '\n');
+		SLog += "\n\r[!] Taille de carte invalide.";
+		return KScreenMenu;
+	}
+
+	/* Même minimum que les options KSizeX / KSizeY ; la bordure seule borne le côté (ExportMatrice() ne borne pas la surface) */
+	if (NbLine < 4 || NbColumn < 4 || NbLine > KMaxChunkedSide || NbColumn > KMaxChunkedSide) {
+		SLog += "\n\r[!] Taille de carte invalide : entre 4 et " + to_string(KMaxChunkedSide) + " cases de côté.";
+		return KScreenMenu;
+	}
 
-	CMatrice EmptyMatrice = InitMatrice(NbLine, NbColumn, PlayerX, PlayerY);
+	InitMatch(Game, GetRules(), KSeed);
+	CChunkedMatrice EmptyMatrice = InitMatrice <CChunkedMatrice>(Game.m_rules, NbLine, NbColumn, PlayerX, PlayerY);
+
+	/* Les bonus sont posés dans les bornes des règles (PutBonus()) : ce sont celles de la carte éditée */
+	Game.m_rules.m_sizeX = NbColumn - 1;
+	Game.m_rules.m_sizeY = NbLine - 1;
+	ResetLayers(Game, EmptyMatrice);
 	SPlayer EmptyPlayer = InitPlayer(1, 1, 1, 1, '-');
 	SBonus EmptyBonus;
 	SObstacle EmptyObstacle;
 
-	InitCurses();
+	CEventLoop Loop;
+	Loop.Start();
 
 	while (true) {
 
+		if (CEventLoop::KEventFrame == Loop.Wait(Key)) {
+			Frame.Begin();
+			ClearScreen();
+			ShowTitle("editor.title");
+			PrintLines(3);
+			Couleur(KBleu, KHJaune);
+			cout << "[+] Votre carte ressemble actuellement à cela : \n\r";
 
-		ShowTitle("editor.title");
-		PrintLines(3);
-		Couleur(KBleu, KHJaune);
-		cout << "[+] Votre carte ressemble actuellement à cela : \n\r";
-
-		ShowMatrice(EmptyMatrice, false);
-		Couleur(KCyan);
-		cout << "\n\r\r\n\rUtilisez les A,Z,S,D pour vous diriger sur la map. \n\rCliquez sur " << BonusX << ", " << BonusY << " ou " << BonusZ << " pour placer des bonus" <<
-			"\n\rCliquez sur ENTREE pour placer des obstacles\n\rUne fois votre edition finie, veuillez cliquer sur la touche M (menu)\n\r\n\rPour sauvegarder, veuillez maintenir CTRL+S. \n\r";
-		Couleur(KReset);
-		ListenKeyboard();
-
-		if (!IsFirstTime)
-			Key = getch();
+			ShowMatrice(EmptyMatrice, false, EmptyPlayer.m_X, EmptyPlayer.m_Y);
+			Couleur(KCyan);
+			cout << "\n\r\r\n\rUtilisez les A,Z,S,D pour vous diriger sur la map. \n\rCliquez sur " << BonusX << ", " << BonusY << " ou " << BonusZ << " pour placer des bonus" <<
+				"\n\rCliquez sur ENTREE pour placer des obstacles\n\rUne fois votre edition finie, veuillez cliquer sur la touche M (menu)\n\r\n\rPour sauvegarder, veuillez maintenir CTRL+S. \n\r";
+			Couleur(KReset);
+			Frame.End();
+			continue;
+		}
 
-		refresh();
-		endwin();
+		Loop.Invalidate();
 
-		if (Key == 'm') {
-			DisplayMenu();
-			endwin();
-			break;
-		}
+		if (Key == 'm') return KScreenMenu;
 
 
 		//DEPLACEMENTS
 		else if (Key == 'z')
-			MovePlayer(EmptyMatrice, Key, EmptyPlayer);
+			MovePlayer(Game, EmptyMatrice, Key, EmptyPlayer);
 
 		else if (Key == 'q')
-			MovePlayer(EmptyMatrice, Key, EmptyPlayer);
+			MovePlayer(Game, EmptyMatrice, Key, EmptyPlayer);
 
 		else if (Key == 's')
-			MovePlayer(EmptyMatrice, Key, EmptyPlayer);
+			MovePlayer(Game, EmptyMatrice, Key, EmptyPlayer);
 
 		else if (Key == 'd')
-			MovePlayer(EmptyMatrice, Key, EmptyPlayer);
+			MovePlayer(Game, EmptyMatrice, Key, EmptyPlayer);
 
 		//CREATION BONUS
 		else if (Key == tolower(BonusX)) {
 			EmptyBonus = InitBonus(EmptyPlayer.m_X, EmptyPlayer.m_Y, BonusX);
-			MovePlayer(EmptyMatrice, 'd', EmptyPlayer);
-			PutBonus(EmptyMatrice, EmptyBonus);
+			MovePlayer(Game, EmptyMatrice, 'd', EmptyPlayer);
+			PutBonus(Game, EmptyMatrice, EmptyBonus);
 		}
 
 		else if (Key == tolower(BonusY)) {
 			EmptyBonus = InitBonus(EmptyPlayer.m_X, EmptyPlayer.m_Y, BonusY);
-			MovePlayer(EmptyMatrice, 'd', EmptyPlayer);
-			PutBonus(EmptyMatrice, EmptyBonus);
+			MovePlayer(Game, EmptyMatrice, 'd', EmptyPlayer);
+			PutBonus(Game, EmptyMatrice, EmptyBonus);
 		}
 
 		else if (Key == tolower(BonusZ)) {
 			EmptyBonus = InitBonus(EmptyPlayer.m_X, EmptyPlayer.m_Y, BonusZ);
-			MovePlayer(EmptyMatrice, 'd', EmptyPlayer);
-			PutBonus(EmptyMatrice, EmptyBonus);
+			MovePlayer(Game, EmptyMatrice, 'd', EmptyPlayer);
+			PutBonus(Game, EmptyMatrice, EmptyBonus);
 		}
 
 		//OBSTACLE
 
 		else if ('\n' == Key /*ENTREE*/) {
 			EmptyObstacle = InitObstacle(EmptyPlayer.m_X, EmptyPlayer.m_Y, CaseObstacle);
-			MovePlayer(EmptyMatrice, 'd', EmptyPlayer);
-			PutObstacle(EmptyMatrice, EmptyObstacle);
+			MovePlayer(Game, EmptyMatrice, 'd', EmptyPlayer);
+			PutObstacle(Game, EmptyMatrice, EmptyObstacle);
 		}
 
 
 		//SAVE
 
 		else if ((char(19)) == Key /*CTRL+S*/) {
-			EmptyMatrice[EmptyPlayer.m_Y][EmptyPlayer.m_X] = CaseEmpty;
+			Loop.Stop();	/* le nom est lu en mode canonique */
+			EmptyMatrice.Set(EmptyPlayer.m_Y, EmptyPlayer.m_X, CaseEmpty);
 
 			string Name;
 			Couleur(KRouge);
 			cout << "\n\r[?] Nom de la map ? ";
 			cin >> Name;
 			string FullName = "./map/MyMap_" + Name + ".map";
-			ExportMatrice(EmptyMatrice, FullName);
-			Couleur(KCyan);
-			cout << "[+]Map exportée à l'emplacement : " << FullName << "\n\r";
+			if (ExportMatrice(EmptyMatrice, FullName)) {
+				Couleur(KCyan);
+				cout << "[+]Map exportée à l'emplacement : " << FullName << "\n\r";
+			}
+			else cout << SLog << "\n\r";
 			Couleur(KReset);
 
-			refresh();
-			endwin();
 			SLog.clear();
-			DisplayMenu();
+			WaitForEnter();
+			return KScreenMenu;
 		}
 
-		ClearScreen();
-		IsFirstTime = false;
-
 		//SOLVING OBSTACLE BUG FOR MAP CREATION
 
-		EmptyMatrice[1][1] = CaseEmpty;
+		EmptyMatrice.Set(1, 1, CaseEmpty);
 
 	}
+}//DisplayEditor()
 
 
-	ShowMatrice(EmptyMatrice);
-	refresh();
-	endwin();
-	DisplayMenu();
-}//DisplayEditor()
+// BENCHMARK
+
+#if defined(BENCH_COUNT_ALLOC)
+
+const bool KIsAllocationCounted(true);	/*!< operator new is replaced : --bench reports allocations/op */
+
+/*! Number of operator new calls of the thread (allocations/op of --bench) : one counter per thread, the workers of --batch never share it */
+thread_local uint64_t NbAllocation(0);
+
+/*!
+* \brief Allocate memory, counting the allocation
+*
+* Jamais inliné : gcc verrait sinon un free() sur un pointeur venant de new (-Wmismatched-new-delete).
+* \param[in] Size Number of bytes
+* \return The allocated memory
+*/
+__attribute__((noinline)) void * operator new(size_t Size) {
+	++NbAllocation;
+
+	void * Ptr = malloc(0 == Size ? 1 : Size);
+	if (nullptr == Ptr) throw bad_alloc();
+	return Ptr;
+}//operator new()
+
+/*!
+* \brief Free memory allocated by operator new()
+* \param[in] Ptr The memory to free
+*/
+__attribute__((noinline)) void operator delete(void * Ptr) noexcept {
+	free(Ptr);
+}//operator delete()
+
+#else
+
+/* Le jeu garde l'allocateur standard : aucune allocation ne paie le compteur */
+const bool KIsAllocationCounted(false);	/*!< built without -DBENCH_COUNT_ALLOC : --bench can't count the allocations */
+const uint64_t NbAllocation(0);	/*!< never incremented */
+
+#endif
+
+/**
+* \class CNullBuffer
+* \brief Sortie qui ignore tout ce qu'on lui écrit.
+*
+* Pendant une mesure, cout écrit ici : l'affichage est bien calculé mais jamais envoyé à la console.
+*/
+class CNullBuffer : public streambuf {
+protected:
+	int_type overflow(int_type Ch) override { return traits_type::not_eof(Ch); }
+	streamsize xsputn(const char *, streamsize Count) override { return Count; }
+}; //CNullBuffer
+
+/**
+* \struct SBenchResult
+* \brief Résultat d'une mesure.
+*
+* La structure SBenchResult contient le temps moyen d'une opération (m_nsPerOp), le nombre moyen
+* d'allocations par opération (m_allocPerOp) et le nombre d'opérations mesurées (m_nbOp).
+*/
+typedef struct {
+	double m_nsPerOp;
+	double m_allocPerOp;
+	uint64_t m_nbOp;
+} SBenchResult;
+
+const double KBenchTime = 0.2;	/*!< minimum duration of a measure (seconds) */
+
+/*!
+* \brief Time an operation : it is run by batches (1, 2, 4...) until KBenchTime is reached
+*
+* Un premier appel, non mesuré, remplit les caches (chemin du bot, titres...). La sortie console (cout)
+* est envoyée vers un CNullBuffer pendant la mesure.
+* \param[in] Operation The operation to measure
+* \return The measure
+*/
+template <typename TOperation>
+SBenchResult Measure(TOperation Operation) {
+
+	CNullBuffer Null;
+	streambuf * Previous = cout.rdbuf(&Null);
+
+	Operation();
+
+	const uint64_t FirstAllocation = NbAllocation;
+	const chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+	chrono::duration <double> Elapsed(0);
+	uint64_t NbOp(0);
+
+	for (uint64_t Batch(1); Elapsed.count() < KBenchTime; Batch *= 2) {
+		for (uint64_t i(0); i < Batch; ++i) Operation();
+		NbOp += Batch;
+		Elapsed = chrono::steady_clock::now() - Start;
+	}
+
+	const uint64_t Allocations = NbAllocation - FirstAllocation;
+	cout.rdbuf(Previous);
+
+	SBenchResult Result;
+	Result.m_nsPerOp = Elapsed.count() * 1e9 / NbOp;
+	Result.m_allocPerOp = double(Allocations) / NbOp;
+	Result.m_nbOp = NbOp;
+	return Result;
+}//Measure()
+
+/*!
+* \brief Print one line of the benchmark report
+* \param[in] Name Measured operation
+* \param[in] Size Map size
+* \param[in] Result The measure
+*/
+void ShowBenchResult(const string & Name, const unsigned Size, const SBenchResult & Result) {
+	cout << left << setw(36) << Name << setw(13) << to_string(Size) + 'x' + to_string(Size) << right
+		<< fixed << setprecision(1) << setw(16) << Result.m_nsPerOp << setw(14) << setprecision(2);
+	if (KIsAllocationCounted) cout << Result.m_allocPerOp;
+	else cout << '-';
+	cout << setw(12) << Result.m_nbOp << defaultfloat << endl;
+}//ShowBenchResult()
+
+/*!
+* \brief Time MovePlayer() : a player walks from one side of the map to the other and back
+* \param[in] Match The game, layers sized to Map
+* \param[in] Map The map
+* \return The measure
+*/
+template <typename TMatrice>
+SBenchResult MeasureWalk(SMatch & Match, TMatrice & Map) {
+	const SRules & Rules = Match.m_rules;
+	SPlayer Player = InitPlayer(1, 1, 1, Map.NbLine() / 2, Rules.m_tokenPlayerX);
+	char Move = Rules.m_mouvRight;
+
+	return Measure([&]() {
+		if (Player.m_X + 2 >= Map.NbColumn()) Move = Rules.m_mouvLeft;
+		else if (Player.m_X <= 1) Move = Rules.m_mouvRight;
+		MovePlayer(Match, Map, Move, Player);
+	});
+}//MeasureWalk()
+
+/*!
+* \brief Memory used by the four layers of a game
+* \param[in] Match The game
+* \return Bytes of the allocated tiles
+*/
+size_t LayersMemorySize(const SMatch & Match) {
+	return Match.m_obstacleLayer.MemorySize() + Match.m_bonusLayer.MemorySize()
+		+ Match.m_playerLayerX.MemorySize() + Match.m_playerLayerY.MemorySize();
+}//LayersMemorySize()
+
+/*!
+* \brief Time the game primitives on maps from 10x10 to MaxSize x MaxSize (ns/op and allocations/op)
+* \param[in] MaxSize Biggest map size
+*/
+void RunBenchmark(const unsigned MaxSize) {
+
+	const unsigned Sizes[] = { 10, 64, 256, 1024, 4096 };
+	const string MapName = "bench_" + to_string(getpid());
+	const bool IsMapDirCreated = (0 == mkdir("./map", 0755));	/* LoadMapByFile() lit dans ./map */
+
+	if (!KIsAllocationCounted) cout << "[+] allocs/op non mesurées : compiler avec -DBENCH_COUNT_ALLOC" << endl;
+	cout << left << setw(36) << "Mesure" << setw(13) << "Taille" << right << setw(16) << "ns/op"
+		<< setw(14) << "allocs/op" << setw(12) << "ops" << endl;
+
+	for (const unsigned Size : Sizes) {
+		if (Size > MaxSize) break;
+
+		SRules Rules = GetRules();
+		Rules.m_sizeX = Size;
+		Rules.m_sizeY = Size;
+
+		SMatch Match;
+		InitMatch(Match, Rules, 1);
+		CMatrice Map = GenerateGameMap(Match);
+
+		ShowBenchResult("InitMatrice", Size, Measure([&]() {
+			CMatrice Tmp = InitMatrice(Rules, Size + 1, Size + 1, Match.m_playerX, Match.m_playerY);
+		}));
+
+		ShowBenchResult("ShowMatrice (sortie nulle)", Size, Measure([&]() {
+			ShowMatrice(Map, false);
+		}));
+
+		/* La fenêtre suit un joueur qui saute d'un bout à l'autre de la carte : le coût ne dépend que de la fenêtre */
+		{
+			CBoardRenderer Renderer;
+			SPlayer Player = InitPlayer(1, 1, 1, 1, Rules.m_tokenPlayerX);
+			unsigned Step(0);
+
+			Renderer.SetView(30, 100);
+			for (unsigned IsMinimap(0); IsMinimap < 2; ++IsMinimap) {
+				ShowBenchResult(IsMinimap ? "CBoardRenderer minimap (100x30)" : "CBoardRenderer (vue 100x30)", Size, Measure([&]() {
+					Player.m_X = 1 + (Step * 37) % (Size - 1);
+					Player.m_Y = 1 + (Step++ * 11) % (Size - 1);
+					Renderer.Follow(Player, Match.m_playerY);
+					Renderer.Draw(Map);
+				}));
+				Renderer.ToggleMinimap();
+			}
+		}
+
+		/* L'export attend le disque (fsync()) : les encodeurs sont mesurés à part, en mémoire */
+		ShowBenchResult("ExportMatrice (fsync compris)", Size, Measure([&]() {
+			ExportMatrice(Map, "./map/MyMap_" + MapName + ".map");
+		}));
+
+		ShowBenchResult("LoadMapByFile", Size, Measure([&]() {
+			CMatrice Tmp = LoadMapByFile(MapName);
+		}));
+		unlink(("./map/MyMap_" + MapName + ".map").c_str());
+
+		ShowBenchResult("EncodeMapBinary + DecodeMapBinary", Size, Measure([&]() {
+			const string Binary = EncodeMapBinary(Map);
+			CMatrice Tmp;
+			DecodeMapBinary(Binary.data(), Binary.size(), Tmp);
+		}));
+
+		for (unsigned Difficulty(1); Difficulty <= 2; ++Difficulty) {
+			CMatrice Tmp = Map;
+			ShowBenchResult(1 == Difficulty ? "GenerateStaticObject (facile)" : "GenerateStaticObject (difficile)", Size, Measure([&]() {
+				GenerateStaticObject(Match, Tmp, Difficulty, 6, 5);
+			}));
+		}
+
+		{
+			SRules Dense = Rules;
+			Dense.m_obstacleDensity = 30;
+			Dense.m_bonusDensity = 5;
+
+			SMatch Tmp;
+			InitMatch(Tmp, Dense, 1);
+			ShowBenchResult("GenerateGameMap (30 % obstacles)", Size, Measure([&]() {
+				CMatrice TmpMap = GenerateGameMap(Tmp);
+			}));
+		}
+
+		/* VObstacle grandit jusqu'à un obstacle pour 8 cases, mais aucun autour du joueur : le déplacement est toujours autorisé */
+		{
+			CMatrice Tmp = Map;
+			SPlayer Player = InitPlayer(1, 1, Size / 2, Size / 2, Rules.m_tokenPlayerX);
+			char Moves[4] = { Rules.m_mouvTop, Rules.m_mouvBot, Rules.m_mouvLeft, Rules.m_mouvRight };
+			const unsigned Steps[] = { 512, 64, 16, 8 };	/* un obstacle pour N cases */
+			unsigned NbMove(0), NbTry(0);
+
+			ResetLayers(Match, Tmp);
+			for (const unsigned Step : Steps) {
+				for (; NbTry < (Size + 1) * (Size + 1) / Step; ++NbTry) {
+					SObstacle Obstacle = InitObstacle(Match.m_random.Range(1, Size - 1), Match.m_random.Range(1, Size - 1), Rules.m_caseObstacle);
+					const unsigned Dx = Obstacle.m_X > Player.m_X ? Obstacle.m_X - Player.m_X : Player.m_X - Obstacle.m_X;
+					const unsigned Dy = Obstacle.m_Y > Player.m_Y ? Obstacle.m_Y - Player.m_Y : Player.m_Y - Obstacle.m_Y;
+					if (Dx + Dy > 1) PutObstacle(Match, Tmp, Obstacle);
+				}
+
+				ShowBenchResult("IsMovementForbidden (" + to_string(Match.m_obstacles.size()) + " obs.)", Size, Measure([&]() {
+					IsMovementForbidden(Match, Player, Moves[++NbMove % 4]);
+				}));
+			}
+
+			ShowBenchResult("DetectObstacle (" + to_string(Match.m_obstacles.size()) + " obs.)", Size, Measure([&]() {
+				DetectObstacle(Match, Tmp);
+			}));
+		}
+
+		{
+			CMatrice Tmp = InitMatrice(Rules, Size + 1, Size + 1, Match.m_playerX, Match.m_playerY);
+			SPlayer Player = InitPlayer(1, 1, Size / 2, Size / 2, Rules.m_tokenPlayerX);
+			ResetLayers(Match, Tmp);
+
+			ShowBenchResult("GetBonus", Size, Measure([&]() {
+				GetBonus(Match, Tmp, Player, Rules.m_mouvRight);
+			}));
+		}
+
+		/* Même marche sur les deux matrices : la carte en tuiles n'alloue que la bordure et les tuiles traversées */
+		{
+			CMatrice Dense = InitMatrice(Rules, Size + 1, Size + 1, Match.m_playerX, Match.m_playerY);
+			CChunkedMatrice Chunked = InitMatrice <CChunkedMatrice>(Rules, Size + 1, Size + 1, Match.m_playerX, Match.m_playerY);
+			ResetLayers(Match, Dense);
+
+			const SBenchResult DenseWalk = MeasureWalk(Match, Dense);
+			ShowBenchResult("MovePlayer (" + to_string((Dense.NbCase() + LayersMemorySize(Match)) / 1024) + " Ko)", Size, DenseWalk);
+
+			ResetLayers(Match, Chunked);
+			const SBenchResult ChunkedWalk = MeasureWalk(Match, Chunked);
+			ShowBenchResult("MovePlayer en tuiles (" + to_string((Chunked.MemorySize() + LayersMemorySize(Match)) / 1024) + " Ko)", Size, ChunkedWalk);
+		}
+
+		/* Le bot poursuit le premier joueur ; une fois attrapé, celui-ci réapparaît dans le coin le plus éloigné */
+		{
+			InitMatch(Match, Rules, 1);
+			CMatrice Tmp = GenerateGameMap(Match);
+			unsigned Tour(0);
+
+			ShowBenchResult("MoveBot", Size, Measure([&]() {
+				MoveBot(Match, Tmp, Tour++);
+
+				if (CheckIfWin(Match)) {
+					SPlayer & Target = Match.m_playerX;
+					FillPlayerRect(Match, Tmp, Target, Target.m_Y, Target.m_X, Target.m_sizeY, Target.m_sizeX, false);
+					Target.m_X = (Match.m_playerY.m_X < Size / 2 ? Size - 1 : 1);
+					Target.m_Y = (Match.m_playerY.m_Y < Size / 2 ? Size - 1 : 1);
+					FillPlayerRect(Match, Tmp, Target, Target.m_Y, Target.m_X, Target.m_sizeY, Target.m_sizeX, true);
+					Match.m_log.clear();
+				}
+			}));
+		}
+	}
+
+	/* Monde ouvert de 2^20 x 2^20 cases sans bordure : une carte dense n'y tiendrait pas en mémoire */
+	{
+		const unsigned Size(1u << 20);
+		SRules Rules = GetRules();
+		Rules.m_sizeX = Size - 1;
+		Rules.m_sizeY = Size - 1;
+
+		SMatch Match;
+		InitMatch(Match, Rules, 1);
+		CChunkedMatrice World = InitMatrice <CChunkedMatrice>(Rules, Size, Size, Match.m_playerX, Match.m_playerY, false);
+		ResetLayers(Match, World);
+
+		const SBenchResult Walk = MeasureWalk(Match, World);
+		ShowBenchResult("MovePlayer monde ouvert (" + to_string((World.MemorySize() + LayersMemorySize(Match)) / 1024) + " Ko)", Size, Walk);
+	}
+
+	if (IsMapDirCreated) rmdir("./map");
+}//RunBenchmark()
+
+
+// LIGNE DE COMMANDE
+
+/*!
+* \brief Read a number given on the command line
+* \param[in] Arg The argument
+* \param[out] Number The number
+* \param[in] Max Biggest value accepted
+* \return False if Arg is not a number between 0 and Max
+*/
+bool ReadArgNumber(const char * Arg, uint64_t & Number, const uint64_t Max = UINT_MAX) {
+	if ('-' == Arg[0]) return false;	/* stoull() accepte "-1" */
+
+	try {
+		size_t End(0);
+		Number = stoull(Arg, &End);
+		return '\0' == Arg[End] && Number <= Max;
+	}
+	catch (const invalid_argument &) {
+		return false;
+	}
+	catch (const out_of_range &) {
+		return false;
+	}
+}//ReadArgNumber()
+
+/*!
+* \brief Print the command line usage
+* \param[in] Arg The invalid argument
+* \return The exit code of the program
+*/
+int ShowUsage(const string & Arg) {
+	cout << "[!] Argument invalide : " << Arg << endl
+		<< "Usage : ./main.out [-o <option>=<valeur>]..." << endl
+		<< "        ./main.out --convert <source> <destination>" << endl
+		<< "        ./main.out --match <graine> [rounds] [enregistrement]" << endl
+		<< "        ./main.out --replay <enregistrement> [délai en ms]" << endl
+		<< "        ./main.out --batch <parties> [graine] [threads] [rounds]" << endl
+		<< "        ./main.out --bench [taille max]" << endl;
+	return 1;
+}//ShowUsage()
 
 
-int main() {
+int main(int argc, char * argv[]) {
 
 	InitOptions();
-	DisplayMenu();
+	LoadOptions();
+
+	/* -o <option>=<valeur> (répétable, n'importe où) : change une option pour ce lancement seulement */
+	vector <char *> Args(argv, argv + argc);
+	for (auto Arg = Args.begin() + 1; Arg != Args.end();) {
+		if (string(*Arg) != "-o" || Arg + 1 == Args.end()) {
+			++Arg;
+			continue;
+		}
+
+		const string Override(Arg[1]);
+		const size_t Equal = Override.find('=');
+		if (string::npos == Equal || !SetConfig(Override.substr(0, Equal), Override.substr(Equal + 1))) {
+			cout << "[!] Option invalide : " << Override << SLog << endl;
+			return 1;
+		}
+		Arg = Args.erase(Arg, Arg + 2);
+	}
+	argc = int(Args.size());
+	argv = Args.data();
+
+	/* ./main.out --convert <source> <destination> : conversion texte <-> binaire (.cmap) */
+	if (argc == 4 && string(argv[1]) == "--convert")
+		return ConvertMap(argv[2], argv[3]) ? 0 : 1;
+
+	/* ./main.out --match <graine> [rounds] [enregistrement] : partie sans affichage, joueur aléatoire (X) contre le bot (O) */
+	if (argc >= 3 && string(argv[1]) == "--match") {
+		uint64_t Seed, NbRound(100);
+		if (!ReadArgNumber(argv[2], Seed, UINT64_MAX)) return ShowUsage(argv[2]);
+		if (argc >= 4 && !ReadArgNumber(argv[3], NbRound)) return ShowUsage(argv[3]);
+
+		SReplay Replay;
+		ShowMatchResult(RunMatch(GetRules(), Seed, unsigned(NbRound), MakeRandomPolicy(), MakeChaserPolicy(), &Replay));
+		if (argc >= 5 && !SaveReplay(Replay, argv[4])) cout << "[!] Impossible d'écrire " << argv[4] << endl;
+		return 0;
+	}
+
+	/* ./main.out --replay <enregistrement> [délai en ms] : rejoue une partie, sans affichage ou affichée coup par coup */
+	if (argc >= 3 && string(argv[1]) == "--replay") {
+		uint64_t Delay(0);
+		if (argc >= 4 && !ReadArgNumber(argv[3], Delay)) return ShowUsage(argv[3]);
+
+		SReplay Replay;
+		if (!LoadReplay(argv[2], Replay)) {
+			cout << SLog.substr(SLog.find('[')) << endl;
+			return 1;
+		}
+
+		const SMatchResult Result = PlayReplay(Replay, argc >= 4, unsigned(Delay));
+		ShowMatchResult(Result);
+		if (IsReplayMatching(Replay, Result)) return 0;
+
+		cout << "[!] La partie rejouée ne se termine pas comme l'enregistrement ('" << Replay.m_winner << "' en "
+			<< Replay.m_nbTour << " coups, scores " << Replay.m_scoreX << " / " << Replay.m_scoreY << ")" << endl;
+		return 1;
+	}
+
+	/* ./main.out --batch <parties> [graine] [threads] [rounds] : parties sans affichage en parallèle, taux de victoire */
+	if (argc >= 3 && string(argv[1]) == "--batch") {
+		uint64_t NbMatch, FirstSeed(1), NbThread(0), NbRound(100);
+		if (!ReadArgNumber(argv[2], NbMatch)) return ShowUsage(argv[2]);
+		if (argc >= 4 && !ReadArgNumber(argv[3], FirstSeed, UINT64_MAX)) return ShowUsage(argv[3]);
+		if (argc >= 5 && !ReadArgNumber(argv[4], NbThread)) return ShowUsage(argv[4]);
+		if (argc >= 6 && !ReadArgNumber(argv[5], NbRound)) return ShowUsage(argv[5]);
+
+		const SRules Rules = GetRules();
+		ShowBatchResult(Rules, RunBatch(Rules, FirstSeed, unsigned(NbMatch), unsigned(NbRound), unsigned(NbThread), MakeRandomPolicy, MakeChaserPolicy));
+		return 0;
+	}
+
+	/* ./main.out --bench [taille max] : temps (ns/op) et allocations des primitives du jeu, cartes de 10x10 à 4096x4096 */
+	if (argc >= 2 && string(argv[1]) == "--bench") {
+		uint64_t MaxSize(4096);
+		if (argc >= 3 && !ReadArgNumber(argv[2], MaxSize)) return ShowUsage(argv[2]);
+		RunBenchmark(unsigned(MaxSize));
+		return 0;
+	}
+
+	/* Un seul écran actif à la fois : chaque écran rend la main en indiquant le suivant */
+	for (EScreen Screen(KScreenMenu); KScreenQuit != Screen; ) {
+		switch (Screen) {
+		case KScreenSolo:
+			Screen = DisplaySoloIA();
+			break;
+		case KScreenMulti:
+			Screen = DisplayMulti();
+			break;
+		case KScreenEditor:
+			Screen = DisplayEditor();
+			break;
+		case KScreenOption:
+			Screen = DisplayOption();
+			break;
+		default:
+			Screen = DisplayMenu();
+		}
+	}
+
 	endwin();
 	Couleur(KReset);
 	PrintLines(3);